@@ -14,34 +14,64 @@ Description:
 #include "tick_timer.h"
 #include "debug_commands.h"
 #include "helpers.h"
+#include "soft_timers.h"
+#include "scheduler.h"
+#include "inputs.h"
+#include "gpio.h"
 
 // +--------------------------------------------------------------+
 // |                        Public Globals                        |
 // +--------------------------------------------------------------+
 Version_t Version = { VERSION_MAJOR, VERSION_MINOR, VERSION_BUILD };
 
+// +--------------------------------------------------------------+
+// |                     Private Definitions                      |
+// +--------------------------------------------------------------+
+#define APP_STARTUP_BANNER_DELAY 100 //ms
+
 // +--------------------------------------------------------------+
 // |                       Private Globals                        |
 // +--------------------------------------------------------------+
-static bool btnWasDown1 = false;
-static bool btnDebounceTriggered1 = false;
-static bool btnWasDown2 = false;
-static bool btnDebounceTriggered2 = false;
-static bool btnWasDown3 = false;
-static bool btnDebounceTriggered3 = false;
+static SoftTimer_t led1BlinkTimer;
+static SoftTimer_t led2BlinkTimer;
 
 // +--------------------------------------------------------------+
-// |                        Initialization                        |
+// |                      Private Functions                       |
 // +--------------------------------------------------------------+
-void AppInitialize()
+static void AppPrintBanner()
 {
-	MicroDelay(100); //DElay to try and let things settle before trying to do debug output
 	PrintLine("\n+==============================+");
 	PrintLine("|  PIC32MZ Test Bed v%u.%u(%3u)  |", Version.major, Version.minor, Version.build);
 	PrintLine("+==============================+");
 	#if PRODUCTION_MODE
 	WriteLineAt(OutputLevel_Error, "Production Mode!");
 	#endif
+}
+
+//userPntr is the Gpio_t of the LED
+static void AppBlinkLed(SoftTimer_t* timer)
+{
+	GpioToggle((Gpio_t)(u32)timer->userPntr);
+}
+
+// +--------------------------------------------------------------+
+// |                        Initialization                        |
+// +--------------------------------------------------------------+
+void AppInitialize()
+{
+	//Give things time to settle before trying to do debug output, without holding up the rest of startup
+	SchedulerRunAfter(AppPrintBanner, APP_STARTUP_BANNER_DELAY);
+	
+	// +==============================+
+	// |        Blinky Example        |
+	// +==============================+
+	//The LEDs are just on or off, so they're driven straight from gpio.h rather than through the soft PWM.
+	//"pwm TestLed1 [duty]" can still take one over to dim it, and "pwm TestLed1 off" hands it back
+	GpioClear(Gpio_TestLed1);
+	GpioClear(Gpio_TestLed2);
+	GpioClear(Gpio_TestLed3);
+	SoftTimerStart(&led1BlinkTimer, 500, 500, AppBlinkLed, (void*)Gpio_TestLed1);
+	SoftTimerStart(&led2BlinkTimer, 200, 200, AppBlinkLed, (void*)Gpio_TestLed2);
 	
 	//TODO: Any initialization can be done here
 }
@@ -54,37 +84,16 @@ void AppUpdate()
 	// +==============================+
 	// |        Button Example        |
 	// +==============================+
-	bool btnDown1 = (TEST_BTN1_VALUE == LOW);
-	if (btnDown1 != btnWasDown1 && ButtonDebounceTimer1 == 0)
+	InputEvent_t inputEvent;
+	while (InputsPopEvent(&inputEvent))
 	{
-		PrintLineAt(btnDown1 ? OutputLevel_Info : OutputLevel_Debug, "Button1 %s", btnDown1 ? "Pressed" : "Released");
-		btnWasDown1 = btnDown1;
-		ButtonDebounceTimer1 = BUTTON_DEBOUNCE_TIME;
+		if (inputEvent.type == InputEventType_Pressed) { PrintLine_I("%s Pressed", GetInputName(inputEvent.input)); }
+		else { PrintLine_D("%s Released after %ums", GetInputName(inputEvent.input), inputEvent.durationMs); }
+		
+		//TestLed3 is lit while Button3 is held
+		if (inputEvent.input == Input_Button3) { GpioWrite(Gpio_TestLed3, (inputEvent.type == InputEventType_Pressed)); }
 	}
 	
-	bool btnDown2 = (TEST_BTN2_VALUE == LOW);
-	if (btnDown2 != btnWasDown2 && ButtonDebounceTimer2 == 0)
-	{
-		PrintLineAt(btnDown2 ? OutputLevel_Info : OutputLevel_Debug, "Button2 %s", btnDown2 ? "Pressed" : "Released");
-		btnWasDown2 = btnDown2;
-		ButtonDebounceTimer2 = BUTTON_DEBOUNCE_TIME;
-	}
-	
-	bool btnDown3 = (TEST_BTN3_VALUE == LOW);
-	if (btnDown3 != btnWasDown3 && ButtonDebounceTimer3 == 0)
-	{
-		PrintLineAt(btnDown3 ? OutputLevel_Info : OutputLevel_Debug, "Button3 %s", btnDown3 ? "Pressed" : "Released");
-		btnWasDown3 = btnDown3;
-		ButtonDebounceTimer3 = BUTTON_DEBOUNCE_TIME;
-	}
-	
-	// +==============================+
-	// |        Blinky Example        |
-	// +==============================+
-	TEST_LED1_VALUE = ((TickCounterMs % 1000) >= 500) ? HIGH : LOW;
-	TEST_LED2_VALUE = ((TickCounterMs % 400) >= 200) ? HIGH : LOW;
-	TEST_LED3_VALUE = btnDown3 ? HIGH : LOW;
-	
 	// +==============================+
 	// |      Handle Debug Input      |
 	// +==============================+
@@ -92,5 +101,6 @@ void AppUpdate()
 	if (newCommand != nullptr)
 	{
 		HandleDebugCommand(newCommand);
+		SecCountup(LastCommand) = 0;
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,245 @@
+/*
+File:   bench.c
+Author: Taylor Robbins
+Date:   10\19\2026
+Description:
+	** Holds the "bench" commands that measure how fast this board does a few basic things so we have baseline numbers
+	** to compare against after a toolchain, optimization level or configuration bit change. Everything is timed with
+	** the CP0 Count register and reported in core (SYSCLK) cycles. TestPin6 is toggled by every test so the results
+	** can also be checked with a scope.
+	
+	** The ISR tests use the two core software interrupts, which we can trigger from C at an exact point in time.
+	** CS0 saves the registers it uses on the stack (ipl3SOFT) and CS1 switches to a shadow register set (ipl4SRS,
+	** PRISS gives priority 4 its own set) so comparing them gives the cost of the software context save.
+	** ISR numbers are min/avg/max over BENCH_NUM_ISR_SAMPLES since other interrupts can land in the middle of a sample
+*/
+
+#include "app.h"
+#include "bench.h"
+
+#include "micro.h"
+#include "debug.h"
+#include "gpio.h"
+
+// +--------------------------------------------------------------+
+// |                     Private Definitions                      |
+// +--------------------------------------------------------------+
+#define BENCH_PIN                   Gpio_TestPin6
+#define BENCH_CYCLES_PER_COUNT      2 //CP0 Count runs at SYSCLK/2
+#define BENCH_DMA_TIMEOUT           MICRO_ONE_MS_COUNT
+#define BENCH_ISR_TIMEOUT           MICRO_ONE_MS_COUNT
+
+#if ((BENCH_NUM_TOGGLES % 8) != 0)
+#error BENCH_NUM_TOGGLES must be a multiple of 8
+#endif
+
+typedef struct
+{
+	u32 numSamples;
+	u32 minCycles;
+	u32 maxCycles;
+	u32 totalCycles;
+} BenchStat_t;
+
+// +--------------------------------------------------------------+
+// |                       Private Globals                        |
+// +--------------------------------------------------------------+
+static volatile unsigned int* benchInvReg = nullptr;
+static u32 benchPinMask = 0;
+static volatile u32 isrEntryCount = 0;
+static volatile u32 isrExitCount = 0;
+static volatile bool isrDone = false;
+
+static u32 dmaSource[BENCH_DMA_NUM_WRITES] __attribute__((coherent, aligned(16)));
+static u8 memcpySource[BENCH_MEMCPY_SIZE] __attribute__((aligned(16)));
+static u8 memcpyDest[BENCH_MEMCPY_SIZE] __attribute__((aligned(16)));
+
+// +--------------------------------------------------------------+
+// |                      Private Functions                       |
+// +--------------------------------------------------------------+
+static void BenchStatAdd(BenchStat_t* stat, u32 numCounts)
+{
+	u32 numCycles = numCounts * BENCH_CYCLES_PER_COUNT;
+	if (stat->numSamples == 0 || numCycles < stat->minCycles) { stat->minCycles = numCycles; }
+	if (numCycles > stat->maxCycles) { stat->maxCycles = numCycles; }
+	stat->totalCycles += numCycles;
+	stat->numSamples++;
+}
+
+static void BenchStatPrint(const char* name, const BenchStat_t* stat)
+{
+	PrintLine_I("  %-22s min %3u  avg %3u  max %4u cycles", name, stat->minCycles, stat->totalCycles / stat->numSamples, stat->maxCycles);
+}
+
+//Prints how fast a pin could be toggled if each toggle took this long (a full square wave period is 2 toggles)
+static void BenchPrintToggleRate(const char* name, u32 numCounts, u32 numToggles)
+{
+	u32 cyclesX100 = (u32)(((u64)numCounts * BENCH_CYCLES_PER_COUNT * 100) / numToggles);
+	u32 squareWaveKhz = (cyclesX100 > 0) ? (u32)(((u64)MICRO_SYS_CLK_FREQ * 100) / cyclesX100 / 2 / 1000) : 0;
+	PrintLine_I("  %-22s %u.%02u cycles/toggle (%u.%03uMHz square wave)", name, cyclesX100 / 100, cyclesX100 % 100, squareWaveKhz / 1000, squareWaveKhz % 1000);
+}
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void BenchInit()
+{
+	benchInvReg = GpioPorts[GpioPins[BENCH_PIN].port].latInvReg;
+	benchPinMask = GpioPins[BENCH_PIN].mask;
+	
+	PRISSbits.PRI4SS = 1; //Priority 4 interrupts use shadow register set 1. Nothing else runs at priority 4
+	IPC0bits.CS0IP = 3; IPC0bits.CS0IS = 0; //Int priority 3.0 (ipl3SOFT)
+	IPC0bits.CS1IP = 4; IPC0bits.CS1IS = 0; //Int priority 4.0 (ipl4SRS)
+	IFS0bits.CS0IF = CLEARED;
+	IFS0bits.CS1IF = CLEARED;
+	IEC0bits.CS0IE = ENABLED;
+	IEC0bits.CS1IE = ENABLED;
+}
+
+void BenchToggle()
+{
+	u32 tIndex;
+	u32 startCount;
+	u32 numCounts;
+	WriteLine_I("GPIO toggle (interrupts off):");
+	
+	MicroDisableInterrupts();
+	startCount = _CP0_GET_COUNT();
+	for (tIndex = 0; tIndex < BENCH_NUM_TOGGLES; tIndex++) { GpioToggle(BENCH_PIN); }
+	numCounts = _CP0_GET_COUNT() - startCount;
+	MicroEnableInterrupts();
+	BenchPrintToggleRate("GpioToggle()", numCounts, BENCH_NUM_TOGGLES);
+	
+	volatile unsigned int* invReg = benchInvReg;
+	u32 mask = benchPinMask;
+	MicroDisableInterrupts();
+	startCount = _CP0_GET_COUNT();
+	for (tIndex = 0; tIndex < BENCH_NUM_TOGGLES; tIndex += 8)
+	{
+		*invReg = mask; *invReg = mask; *invReg = mask; *invReg = mask;
+		*invReg = mask; *invReg = mask; *invReg = mask; *invReg = mask;
+	}
+	numCounts = _CP0_GET_COUNT() - startCount;
+	MicroEnableInterrupts();
+	BenchPrintToggleRate("LATxINV store", numCounts, BENCH_NUM_TOGGLES);
+}
+
+void BenchIsr()
+{
+	BenchStat_t entryStats[2];
+	BenchStat_t exitStats[2];
+	BenchStat_t roundTripStats[2];
+	ClearArray(entryStats);
+	ClearArray(exitStats);
+	ClearArray(roundTripStats);
+	const u32 flagMasks[2] = { _IFS0_CS0IF_MASK, _IFS0_CS1IF_MASK };
+	
+	u32 sIndex;
+	for (sIndex = 0; sIndex < BENCH_NUM_ISR_SAMPLES * 2; sIndex++)
+	{
+		u32 type = (sIndex % 2); //alternate so both see the same background interrupt load
+		isrDone = false;
+		u32 startCount = _CP0_GET_COUNT();
+		IFS0SET = flagMasks[type];
+		while (!isrDone && (_CP0_GET_COUNT() - startCount) < BENCH_ISR_TIMEOUT) { }
+		u32 endCount = _CP0_GET_COUNT();
+		if (!isrDone)
+		{
+			IFS0CLR = flagMasks[type];
+			PrintLine_E("  CS%u interrupt didn't run, is it enabled?", type);
+			return;
+		}
+		BenchStatAdd(&entryStats[type], isrEntryCount - startCount);
+		BenchStatAdd(&exitStats[type], endCount - isrExitCount);
+		BenchStatAdd(&roundTripStats[type], endCount - startCount);
+	}
+	
+	WriteLine_I("Software interrupt, CS0 ipl3SOFT:");
+	BenchStatPrint("Entry latency", &entryStats[0]);
+	BenchStatPrint("Exit latency", &exitStats[0]);
+	BenchStatPrint("Round trip", &roundTripStats[0]);
+	WriteLine_I("Software interrupt, CS1 ipl4SRS (shadow registers):");
+	BenchStatPrint("Entry latency", &entryStats[1]);
+	BenchStatPrint("Exit latency", &exitStats[1]);
+	BenchStatPrint("Round trip", &roundTripStats[1]);
+}
+
+void BenchDma()
+{
+	WriteLine_I("DMA toggle (channel 1, one forced cell):");
+	u32 wIndex;
+	for (wIndex = 0; wIndex < BENCH_DMA_NUM_WRITES; wIndex++) { dmaSource[wIndex] = benchPinMask; }
+	
+	DMACONbits.ON = ENABLED;
+	DCH1CON  = 0x00000000; DCH1CONbits.CHPRI = 0;
+	DCH1ECON = 0x00000000;
+	DCH1INT  = 0x00000000;
+	DCH1SSA  = KVA_TO_PA(&dmaSource[0]);
+	DCH1DSA  = KVA_TO_PA(benchInvReg);
+	DCH1SSIZ = sizeof(dmaSource);
+	DCH1DSIZ = sizeof(u32); //Every word goes to the same register
+	DCH1CSIZ = sizeof(dmaSource); //The whole block is one cell so one CFORCE moves all of it
+	DCH1CONbits.CHEN = ENABLED;
+	
+	u32 startCount = _CP0_GET_COUNT();
+	DCH1ECONSET = _DCH1ECON_CFORCE_MASK;
+	while (!IsFlagSet(DCH1INT, _DCH1INT_CHBCIF_MASK) && (_CP0_GET_COUNT() - startCount) < BENCH_DMA_TIMEOUT) { }
+	u32 numCounts = _CP0_GET_COUNT() - startCount;
+	bool finished = IsFlagSet(DCH1INT, _DCH1INT_CHBCIF_MASK);
+	DCH1CONbits.CHEN = DISABLED;
+	DCH1INT = 0x00000000;
+	
+	if (!finished) { WriteLine_E("  DMA transfer didn't finish"); return; }
+	BenchPrintToggleRate("DMA to LATxINV", numCounts, BENCH_DMA_NUM_WRITES);
+}
+
+void BenchMemcpy()
+{
+	u32 bIndex;
+	for (bIndex = 0; bIndex < BENCH_MEMCPY_SIZE; bIndex++) { memcpySource[bIndex] = (u8)bIndex; }
+	
+	MicroDisableInterrupts();
+	u32 startCount = _CP0_GET_COUNT();
+	u32 rIndex;
+	for (rIndex = 0; rIndex < BENCH_MEMCPY_REPEATS; rIndex++) { memcpy(memcpyDest, memcpySource, BENCH_MEMCPY_SIZE); }
+	u32 numCounts = _CP0_GET_COUNT() - startCount;
+	MicroEnableInterrupts();
+	
+	u32 numBytes = BENCH_MEMCPY_SIZE * BENCH_MEMCPY_REPEATS;
+	u32 kBytesPerSec = (u32)(((u64)numBytes * MICRO_ONE_MS_COUNT) / numCounts); //bytes per ms = KB/s (1000)
+	WriteLine_I("memcpy (cached RAM to RAM, interrupts off):");
+	PrintLine_I("  %u x %u bytes in %u cycles, %u.%03uMB/s (%u.%02u cycles/byte)", BENCH_MEMCPY_REPEATS, BENCH_MEMCPY_SIZE, numCounts * BENCH_CYCLES_PER_COUNT,
+		kBytesPerSec / 1000, kBytesPerSec % 1000, (numCounts * BENCH_CYCLES_PER_COUNT) / numBytes, ((numCounts * BENCH_CYCLES_PER_COUNT * 100) / numBytes) % 100
+	);
+	if (memcmp(memcpyDest, memcpySource, BENCH_MEMCPY_SIZE) != 0) { WriteLine_E("  memcpy result doesn't match!"); }
+}
+
+void BenchPrintReport()
+{
+	PrintLine_N("Bench report: SYSCLK %uMHz, PBCLK3 %uMHz, all numbers in core cycles", MICRO_SYS_CLK_FREQ / 1000000, MICRO_PERF_BUS3_FREQ / 1000000);
+	BenchToggle();
+	BenchIsr();
+	BenchDma();
+	BenchMemcpy();
+}
+
+// +--------------------------------------------------------------+
+// |                   Core Software Interrupts                   |
+// +--------------------------------------------------------------+
+void __ISR(_CORE_SOFTWARE_0_VECTOR, ipl3SOFT) BenchSoftIsr()
+{
+	isrEntryCount = _CP0_GET_COUNT();
+	*benchInvReg = benchPinMask;
+	IFS0CLR = _IFS0_CS0IF_MASK;
+	isrExitCount = _CP0_GET_COUNT();
+	isrDone = true;
+}
+
+void __ISR(_CORE_SOFTWARE_1_VECTOR, ipl4SRS) BenchShadowIsr()
+{
+	isrEntryCount = _CP0_GET_COUNT();
+	*benchInvReg = benchPinMask;
+	IFS0CLR = _IFS0_CS1IF_MASK;
+	isrExitCount = _CP0_GET_COUNT();
+	isrDone = true;
+}
@@ -0,0 +1,129 @@
+/*
+File:   debounce.c
+Author: Taylor Robbins
+Date:   10\19\2026
+Description:
+	** Debounces whole GPIO ports at once using vertical counters. Every bit of a port gets its own 2-bit counter, but
+	** the counters are stored "sideways" in two u16's (counter0 holds bit 0 of every counter, counter1 holds bit 1) so all
+	** 16 counters can be stepped with a handful of bitwise operations. The cost is the same for 1 input or 16.
+	
+	** DebounceSample runs as a periodic scheduler task, so every DEBOUNCE_SAMPLE_PERIOD we read each port in the DEBOUNCE_PORTS table.
+	** Its short deadline keeps the samples evenly spaced even when a background task runs long.
+	** A bit that differs from its debounced state counts up, a bit that matches resets its counter, and when a counter
+	** rolls over (4 samples in a row) the debounced bit flips and we remember the edge until someone takes it
+	
+	** inputs.c debounces TEST_BTN1-3 on its own, because it needs to react on the first edge and timestamp it, which a
+	** sampling debouncer can't do. This is for pins that only need a settled level (no change notification, or a whole
+	** bus of them). It also watches the buttons so the two approaches can be compared on the same presses
+*/
+
+#include "app.h"
+#include "debounce.h"
+
+#include "micro.h"
+#include "debug.h"
+
+// +--------------------------------------------------------------+
+// |                   Private Structures/Types                   |
+// +--------------------------------------------------------------+
+typedef struct
+{
+	const char* name;
+	volatile unsigned int* portReg;
+	u16 mask;
+	
+	u16 state; //debounced value of every bit in the port
+	u16 counter0;
+	u16 counter1;
+	u16 risingEdges;  //bits that became 1 since the last DebounceTakeRisingEdges
+	u16 fallingEdges; //bits that became 0 since the last DebounceTakeFallingEdges
+} DebouncedPort_t;
+
+// +--------------------------------------------------------------+
+// |                     Private Definitions                      |
+// +--------------------------------------------------------------+
+#define DEBOUNCE_PORT_ENTRY(port, mask) { "PORT" #port, &PORT##port, (mask), 0, 0, 0, 0, 0 },
+
+// +--------------------------------------------------------------+
+// |                       Private Globals                        |
+// +--------------------------------------------------------------+
+static DebouncedPort_t DebouncedPorts[DebouncePort_NumPorts] = { DEBOUNCE_PORTS(DEBOUNCE_PORT_ENTRY) };
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void DebounceInit()
+{
+	u32 pIndex;
+	for (pIndex = 0; pIndex < DebouncePort_NumPorts; pIndex++)
+	{
+		DebouncedPort_t* port = &DebouncedPorts[pIndex];
+		port->state = (u16)*port->portReg; //start out matching the pins so we don't report edges at startup
+		port->counter0 = 0xFFFF;
+		port->counter1 = 0xFFFF;
+		port->risingEdges = 0;
+		port->fallingEdges = 0;
+	}
+}
+
+//NOTE: Registered in main.c as a task that runs every DEBOUNCE_SAMPLE_PERIOD
+void DebounceSample()
+{
+	u32 pIndex;
+	for (pIndex = 0; pIndex < DebouncePort_NumPorts; pIndex++)
+	{
+		DebouncedPort_t* port = &DebouncedPorts[pIndex];
+		u16 sample = (u16)*port->portReg;
+		u16 state = port->state;
+		u16 changed = state ^ sample;
+		
+		//Count down from 3 for every bit that differs, reset to 3 for every bit that matches
+		u16 counter0 = ~(port->counter0 & changed);
+		u16 counter1 = counter0 ^ (port->counter1 & changed);
+		changed &= counter0 & counter1; //bits whose counter just rolled over
+		
+		state ^= changed;
+		port->state = state;
+		port->counter0 = counter0;
+		port->counter1 = counter1;
+		port->risingEdges  |= (changed & state);
+		port->fallingEdges |= (changed & ~state);
+	}
+}
+
+u16 DebounceGetState(DebouncePort_t port)
+{
+	Assert(port < DebouncePort_NumPorts);
+	return DebouncedPorts[port].state & DebouncedPorts[port].mask;
+}
+
+u16 DebounceTakeRisingEdges(DebouncePort_t port)
+{
+	Assert(port < DebouncePort_NumPorts);
+	u16 result = DebouncedPorts[port].risingEdges & DebouncedPorts[port].mask;
+	DebouncedPorts[port].risingEdges = 0;
+	return result;
+}
+
+u16 DebounceTakeFallingEdges(DebouncePort_t port)
+{
+	Assert(port < DebouncePort_NumPorts);
+	u16 result = DebouncedPorts[port].fallingEdges & DebouncedPorts[port].mask;
+	DebouncedPorts[port].fallingEdges = 0;
+	return result;
+}
+
+void DebouncePrintPorts()
+{
+	u32 pIndex;
+	for (pIndex = 0; pIndex < DebouncePort_NumPorts; pIndex++)
+	{
+		u16 state = DebounceGetState((DebouncePort_t)pIndex);
+		//Peek at the edges rather than taking them, so printing doesn't steal them from whoever is consuming them
+		u16 rising = DebouncedPorts[pIndex].risingEdges & DebouncedPorts[pIndex].mask;
+		u16 falling = DebouncedPorts[pIndex].fallingEdges & DebouncedPorts[pIndex].mask;
+		PrintLine_I("%s (mask %04X): state %04X, rising %04X, falling %04X not taken yet",
+			DebouncedPorts[pIndex].name, DebouncedPorts[pIndex].mask, state, rising, falling
+		);
+	}
+}
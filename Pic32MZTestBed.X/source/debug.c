@@ -14,8 +14,24 @@ Description:
 	** line that can be interpreted by the receiving program to do various things like change the text color of that line. These output
 	** levels can also be enabled and disabled using the ####_LEVEL_OUTPUT_ENABLED defines.
 	
-	** Debug input is immediately echoed back to the computer when received so that user can see what they are typing. Once we
-	** receive a \n (0x0A) we consider the input done and let the application know that a command is ready to be processed.
+	** If DEBUG_RX_COALESCE_ENABLED is true the Rx interrupt only fires once the hardware Rx FIFO is half full. The tick timer
+	** calls DebugUartRxIdleTick every tick and forces the Rx interrupt if a few trailing bytes have been sitting
+	** in the hardware FIFO for DEBUG_RX_IDLE_TIMEOUT without reaching the threshold. While the line is quiet the interrupt goes
+	** back to firing on every byte, so the first byte of a burst is never stuck waiting for a tick that tickless mode may have
+	** pushed out by ~20ms. While bytes are waiting to be handed over the tick timer keeps 1ms ticks going.
+	
+	** If DEBUG_RX_DMA_ENABLED is true the Rx interrupt is not used at all. DMA channel 0 is triggered by the UART5 Rx IRQ and moves
+	** each byte into one of two ping-pong buffers. When a buffer fills up (or the line goes idle for DEBUG_RX_IDLE_TIMEOUT) the DMA
+	** interrupt hands it to the main loop and switches to the other buffer. DebugUartUpdate then filters and echoes the bytes.
+	
+	** The Rx ISR only moves bytes from the UART into DebugFifoRxRaw. DebugUartUpdate takes newly arrived bytes from there (or from
+	** the DMA buffers) in batches, filters out unprintable characters and echoes them back so the user can see what they are typing.
+	** This keeps the main loop as the only producer for DebugFifoTx. Echo can be turned off at runtime using DebugUartSetEcho.
+	** Once we receive a \n (0x0A) we consider the input done and let the application know that a command is ready to be processed.
+	
+	** Raw transfers (VCD uploads, binary dumps) call DebugUartHoldOutput before their data and DebugUartReleaseOutput after it.
+	** In between, text output and echo go into DebugFifoHeld instead of the UART so nothing lands in the middle of the data.
+	** The transfer itself keeps writing with DebugUartTxPutBytes. Once released, DebugUartUpdate sends the held text in order
 	
 	** The new-line format can be controlled with DEBUG_WINDOWS_LINE_ENDINGS. If this is true then we will send a \r\n for every \n in the debug output
 	** If it is false then we just send \n characters by themselves.
@@ -27,6 +43,10 @@ Description:
 #include "micro.h"
 #include "fifo.h"
 #include "tick_timer.h"
+#include "soft_timers.h"
+#include "isr_stats.h"
+#include "scheduler.h"
+#include "work_queue.h"
 
 // +--------------------------------------------------------------+
 // |                     Private Definitions                      |
@@ -47,6 +67,8 @@ Description:
 #define DBG_UART_MODEbits   U5MODEbits
 #define DBG_UART_STA        U5STA
 #define DBG_UART_STAbits    U5STAbits
+#define DBG_UART_STACLR     U5STACLR
+#define DBG_UART_STASET     U5STASET
 #define DBG_UART_IPCRXIP    IPC45bits.U5RXIP
 #define DBG_UART_IPCRXIS    IPC45bits.U5RXIS
 #define DBG_UART_IPCTXIP    IPC45bits.U5TXIP
@@ -54,6 +76,8 @@ Description:
 #define DBG_UART_IPCERRIP   IPC44bits.U5EIP
 #define DBG_UART_IPCERRIS   IPC44bits.U5EIS
 #define DBG_UART_RXINTFLAG  IFS5bits.U5RXIF
+#define DBG_UART_RXINTSET   IFS5SET
+#define DBG_UART_RXINTMASK  _IFS5_U5RXIF_MASK
 #define DBG_UART_TXINTFLAG  IFS5bits.U5TXIF
 #define DBG_UART_ERRINTFLAG IFS5bits.U5EIF
 #define DBG_UART_RXINTEN    IEC5bits.U5RXIE
@@ -66,6 +90,45 @@ Description:
 #define DBG_UART_ERRVECTOR  _UART5_FAULT_VECTOR
 #define DBG_UART_BITPOS(REGNAME, BITNAME) (_U5##REGNAME##_##BITNAME##_POSITION)
 #define DBG_UART_BITSET(REGNAME, BITNAME, value) ((value) << _U5##REGNAME##_##BITNAME##_POSITION)
+#define DBG_UART_BITMASK(REGNAME, BITNAME) (_U5##REGNAME##_##BITNAME##_MASK)
+
+//NOTE: These are the registers used for the DMA receive path (DEBUG_RX_DMA_ENABLED)
+#define DBG_DMA_CON         DCH0CON
+#define DBG_DMA_CONbits     DCH0CONbits
+#define DBG_DMA_ECON        DCH0ECON
+#define DBG_DMA_ECONbits    DCH0ECONbits
+#define DBG_DMA_INT         DCH0INT
+#define DBG_DMA_INTbits     DCH0INTbits
+#define DBG_DMA_SSA         DCH0SSA
+#define DBG_DMA_DSA         DCH0DSA
+#define DBG_DMA_SSIZ        DCH0SSIZ
+#define DBG_DMA_DSIZ        DCH0DSIZ
+#define DBG_DMA_CSIZ        DCH0CSIZ
+#define DBG_DMA_DPTR        DCH0DPTR
+#define DBG_DMA_IPCIP       IPC33bits.DMA0IP
+#define DBG_DMA_IPCIS       IPC33bits.DMA0IS
+#define DBG_DMA_INTFLAG     IFS4bits.DMA0IF
+#define DBG_DMA_INTSET      IFS4SET
+#define DBG_DMA_INTMASK     _IFS4_DMA0IF_MASK
+#define DBG_DMA_INTEN       IEC4bits.DMA0IE
+#define DBG_DMA_VECTOR      _DMA0_VECTOR
+
+#if DEBUG_RX_DMA_ENABLED
+#define DEBUG_RX_INT_MODE   0b00 //Rx Interrupt Mode = While Rx Buffer is NOT Empty (every byte triggers a DMA transfer)
+#elif DEBUG_RX_COALESCE_ENABLED
+#define DEBUG_RX_INT_MODE   0b01 //Rx Interrupt Mode = While Rx Buffer is 1/2 or more full (4 chars)
+#else
+#define DEBUG_RX_INT_MODE   0b00 //Rx Interrupt Mode = While Rx Buffer is NOT Empty
+#endif
+
+// +--------------------------------------------------------------+
+// |                        Public Globals                        |
+// +--------------------------------------------------------------+
+volatile u32 DebugUartRxIsrCount       = 0;
+volatile u32 DebugUartRxByteCount      = 0;
+volatile u32 DebugUartRxIdleFlushCount = 0;
+volatile u32 DebugUartRxErrorCount       = 0;
+volatile u32 DebugUartRxOverflowCount    = 0;
 
 // +--------------------------------------------------------------+
 // |                       Private Globals                        |
@@ -77,6 +140,13 @@ static struct
 	u8 buffer[DEBUG_INPUT_FIFO_LENGTH];
 } DebugFifoRx;
 
+static struct
+{
+	volatile u32 head;
+	volatile u32 tail;
+	u8 buffer[DEBUG_INPUT_RAW_FIFO_LENGTH];
+} DebugFifoRxRaw;
+
 static struct
 {
 	volatile u32 head;
@@ -84,9 +154,123 @@ static struct
 	u8 buffer[DEBUG_OUTPUT_FIFO_LENGTH];
 } DebugFifoTx;
 
+static struct
+{
+	volatile u32 head;
+	volatile u32 tail;
+	u8 buffer[DEBUG_HELD_FIFO_LENGTH];
+} DebugFifoHeld;
+
 static bool justWroteNewLine = true;
 static u8 readLineBuffer[DEBUG_INPUT_MAX_LENGTH+1];
 static bool debugOverflow = false;
+static bool outputHeld = false;
+static u32 heldDroppedCount = 0;
+static SoftTimer_t debugBackoffTimer;
+static volatile u32 rxIdleTime = 0;
+static u32 rxOverrunCount = 0; //Only touched by DebugUartErrIsr
+#if (DEBUG_RX_COALESCE_ENABLED && !DEBUG_RX_DMA_ENABLED)
+static volatile bool rxSinceLastTick = false; //The Rx ISR ran since DebugUartRxIdleTick last looked
+#endif
+#if ISR_STATS_ENABLED
+static volatile bool rxForcedPending = false; //DebugUartRxIdleTick forced the Rx interrupt at rxForcedCount
+static volatile u32  rxForcedCount = 0;
+static volatile bool txArmedPending = false; //The Tx interrupt was enabled at txArmedCount
+static volatile u32  txArmedCount = 0;
+#endif
+static bool echoEnabled = DEBUG_ECHO_INPUT_CHARACTERS;
+
+#if DEBUG_RX_DMA_ENABLED
+static u8 dmaRxBuffers[2][DEBUG_RX_DMA_BUFFER_SIZE] __attribute__((coherent, aligned(16)));
+static volatile u8 dmaRxActiveIndex = 0;
+static volatile u32 dmaRxReadyLengths[2] = { 0, 0 }; //non-zero when the buffer is full and waiting for the main loop
+static volatile u32 dmaRxLastPntr = 0;
+#endif
+
+// +--------------------------------------------------------------+
+// |                      Private Functions                       |
+// +--------------------------------------------------------------+
+//Everything except a raw transfer's own data goes through here. Held text stays behind in DebugFifoHeld until it's all been sent
+static bool DebugUartTextPutBytes(const u8* dataPntr, u32 dataLength)
+{
+	if (!outputHeld && FifoLength(DebugFifoHeld) == 0) { return DebugUartTxPutBytes(dataPntr, dataLength); }
+	u32 bIndex;
+	for (bIndex = 0; bIndex < dataLength; bIndex++)
+	{
+		if (!FifoPush(DebugFifoHeld, dataPntr[bIndex])) { heldDroppedCount += dataLength - bIndex; break; }
+	}
+	return true;
+}
+
+//Filters and echoes newly received bytes. Only ever called from the main loop
+static void DebugUartProcessRxBytes(const u8* bytes, u32 numBytes)
+{
+	u8 echoBuffer[DEBUG_INPUT_BATCH_SIZE];
+	u32 echoLength = 0;
+	
+	u32 bIndex;
+	for (bIndex = 0; bIndex < numBytes; bIndex++)
+	{
+		u8 newByte = bytes[bIndex];
+		if ((newByte >= ' ' && newByte <= '~') || newByte == '\n' || newByte == '\t')
+		{
+			FifoPushHard(DebugFifoRx, newByte); //Push it on the FIFO to be processed later
+		}
+		else if (newByte != '\b' && newByte != '\r')
+		{
+			newByte = '?';
+		}
+		else { continue; }
+		
+		if (echoEnabled)
+		{
+			echoBuffer[echoLength] = newByte;
+			echoLength++;
+			if (echoLength >= sizeof(echoBuffer))
+			{
+				DebugUartTextPutBytes(echoBuffer, echoLength);
+				echoLength = 0;
+			}
+		}
+	}
+	
+	if (echoLength > 0) { DebugUartTextPutBytes(echoBuffer, echoLength); }
+}
+
+static void DebugUartProcessRxRaw()
+{
+	u8 batch[DEBUG_INPUT_BATCH_SIZE];
+	u32 batchLength = 0;
+	
+	while (FifoLength(DebugFifoRxRaw) > 0)
+	{
+		batchLength = 0;
+		while (batchLength < sizeof(batch) && FifoLength(DebugFifoRxRaw) > 0)
+		{
+			batch[batchLength] = FifoPop(DebugFifoRxRaw);
+			batchLength++;
+		}
+		DebugUartProcessRxBytes(batch, batchLength);
+	}
+}
+
+//NOTE: Posted to the work queue by DebugUartRxIsr when bytes arrive with parity/framing errors
+static void DebugUartEchoRxErrors(u32 numErrors)
+{
+	u8 errorChars[DEBUG_INPUT_BATCH_SIZE];
+	if (numErrors > sizeof(errorChars)) { numErrors = sizeof(errorChars); }
+	if (echoEnabled)
+	{
+		memset(errorChars, '!', numErrors);
+		DebugUartTextPutBytes(errorChars, numErrors);
+	}
+}
+
+//NOTE: Posted to the work queue by DebugUartErrIsr. The hardware FIFO overflowed so some input was lost
+static void DebugUartReportRxOverrun(u32 overrunCount)
+{
+	PrintLine_W("Debug UART Rx overrun #%u, some input was lost", overrunCount);
+}
 
 // +--------------------------------------------------------------+
 // |                       Public Functions                       |
@@ -94,7 +278,11 @@ static bool debugOverflow = false;
 void DebugUartInit()
 {
 	ClearStruct(DebugFifoRx);
+	ClearStruct(DebugFifoRxRaw);
 	ClearStruct(DebugFifoTx);
+	ClearStruct(DebugFifoHeld);
+	outputHeld = false;
+	heldDroppedCount = 0;
 	
 	// +==============================+
 	// |     UART5 Initialization     |
@@ -126,7 +314,7 @@ void DebugUartInit()
 			DBG_UART_BITSET(STA, PERR,     0)    | //
 			DBG_UART_BITSET(STA, RIDLE,    0)    | //
 			DBG_UART_BITSET(STA, ADDEN,    0)    | //Address Character Detect = DISABLED (0)
-			DBG_UART_BITSET(STA, URXISEL,  0b00) | //Rx Interrupt Mode = While Rx Buffer is NOT Empty (0b00)
+			DBG_UART_BITSET(STA, URXISEL,  DEBUG_RX_INT_MODE) | //Rx Interrupt Mode (see DEBUG_RX_INT_MODE)
 			DBG_UART_BITSET(STA, TRMT,     0)    | //
 			DBG_UART_BITSET(STA, UTXBF,    0)    | //
 			DBG_UART_BITSET(STA, UTXEN,    1)    | //UART Transmit Enabled = ENABLED (1)
@@ -154,17 +342,58 @@ void DebugUartInit()
 		
 		// Enable interrupts for Rx and errors.
 		// Tx interrupt will be enabled when data is available to send.
-		DBG_UART_RXINTEN  = ENABLED;
+		DBG_UART_RXINTEN  = DEBUG_RX_DMA_ENABLED ? DISABLED : ENABLED; //the DMA channel watches the Rx IRQ instead
 		DBG_UART_TXINTEN  = DISABLED;
 		DBG_UART_ERRINTEN = ENABLED;
 	}
+	
+	#if DEBUG_RX_DMA_ENABLED
+	// +==============================+
+	// |     Rx DMA Initialization    |
+	// +==============================+
+	{
+		dmaRxActiveIndex = 0;
+		dmaRxReadyLengths[0] = 0;
+		dmaRxReadyLengths[1] = 0;
+		dmaRxLastPntr = 0;
+		
+		DMACONbits.ON = ENABLED;
+		DBG_DMA_CON  = 0x00000000; DBG_DMA_CONbits.CHPRI = 3; //Highest channel priority, no chaining, no auto-enable
+		DBG_DMA_ECON = 0x00000000;
+		DBG_DMA_ECONbits.CHSIRQ = DBG_UART_RXVECTOR; //Start a cell transfer whenever the UART has a byte
+		DBG_DMA_ECONbits.SIRQEN = ENABLED;
+		
+		DBG_DMA_SSA  = KVA_TO_PA(&DBG_UART_RXREG);
+		DBG_DMA_DSA  = KVA_TO_PA(&dmaRxBuffers[0][0]);
+		DBG_DMA_SSIZ = 1;
+		DBG_DMA_DSIZ = DEBUG_RX_DMA_BUFFER_SIZE;
+		DBG_DMA_CSIZ = 1;
+		
+		DBG_DMA_INT = 0x00000000;
+		DBG_DMA_INTbits.CHBCIE = ENABLED; //Block complete (destination buffer full)
+		
+		DBG_DMA_IPCIP = 1; DBG_DMA_IPCIS = 1; //Priority 1.1
+		DBG_DMA_INTFLAG = CLEARED;
+		DBG_DMA_INTEN   = ENABLED;
+		DBG_DMA_CONbits.CHEN = ENABLED;
+	}
+	#endif
+}
+
+//NOTE: Must be called with interrupts disabled
+static void DebugUartEnableTxInt()
+{
+	#if ISR_STATS_ENABLED
+	if (!DBG_UART_TXINTEN) { IsrStatsMark(txArmedCount); txArmedPending = true; }
+	#endif
+	DBG_UART_TXINTEN = ENABLED;
 }
 
 bool DebugUartTxPut(u8 newByte)
 {
 	MicroDisableInterrupts();
 	bool result = FifoPush(DebugFifoTx, newByte);
-	DBG_UART_TXINTEN = ENABLED;
+	DebugUartEnableTxInt();
 	MicroEnableInterrupts();
 	
 	return result;
@@ -180,7 +409,7 @@ bool DebugUartTxPutBytes(const u8* dataPntr, u32 dataLength)
 	{
 		if (!FifoPush(DebugFifoTx, dataPntr[bIndex])) { result = false; }
 	}
-	DBG_UART_TXINTEN = ENABLED;
+	DebugUartEnableTxInt();
 	MicroEnableInterrupts();
 	
 	return result;
@@ -188,9 +417,9 @@ bool DebugUartTxPutBytes(const u8* dataPntr, u32 dataLength)
 
 void DebugPutByte(u8 newByte)
 {
-	if (!debugOverflow && DebugOutputBackoff == 0)
+	if (!debugOverflow && !SoftTimerIsRunning(&debugBackoffTimer))
 	{
-		bool success = DebugUartTxPut(newByte);
+		bool success = DebugUartTextPutBytes(&newByte, 1);
 		if (!success)
 		{
 			debugOverflow = true;
@@ -287,6 +516,57 @@ void DebugUartFlush()
 	}
 }
 
+bool DebugUartTxIdle()
+{
+	return (FifoLength(DebugFifoTx) == 0 && DBG_UART_STAbits.TRMT);
+}
+
+u32 DebugUartTxSpace()
+{
+	return FifoSpace(DebugFifoTx);
+}
+
+//Returns false if another raw transfer has the UART, or text held by the last one hasn't all gone out yet
+bool DebugUartHoldOutput()
+{
+	if (outputHeld || FifoLength(DebugFifoHeld) > 0) { return false; }
+	outputHeld = true;
+	return true;
+}
+
+void DebugUartReleaseOutput()
+{
+	outputHeld = false;
+}
+
+bool DebugUartOutputHeld()
+{
+	return outputHeld;
+}
+
+//NOTE: Anything still in the Tx FIFO will go out at the new rate so wait for DebugUartTxIdle before calling this
+//Returns the actual baud rate we were able to get
+u32 DebugUartSetBaudRate(u32 baudRate)
+{
+	Assert(baudRate > 0);
+	bool highSpeed = (baudRate > DEBUG_BAUD_RATE);
+	u32 divider = highSpeed ? 4 : 16;
+	u32 brgValue = ((MICRO_PERF_BUS2_FREQ + (divider*baudRate)/2) / (divider*baudRate));
+	if (brgValue > 0) { brgValue--; }
+	if (brgValue > 0xFFFF) { brgValue = 0xFFFF; }
+	
+	DBG_UART_MODEbits.BRGH = highSpeed ? 1 : 0;
+	DBG_UART_BRG = brgValue;
+	
+	return DebugUartGetBaudRate();
+}
+
+u32 DebugUartGetBaudRate()
+{
+	u32 divider = DBG_UART_MODEbits.BRGH ? 4 : 16;
+	return MICRO_PERF_BUS2_FREQ / (divider * (DBG_UART_BRG + 1));
+}
+
 char* DebugUartReadLine()
 {
 	u32 lineLength = 0;
@@ -329,8 +609,47 @@ char DebugUartRxGet(u32 offset)
 	return (char)FifoGet(DebugFifoRx, offset);
 }
 
+void DebugUartSetEcho(bool enabled)
+{
+	echoEnabled = enabled;
+}
+
+bool DebugUartGetEcho()
+{
+	return echoEnabled;
+}
+
 void DebugUartUpdate()
 {
+	DebugUartProcessRxRaw();
+	
+	#if DEBUG_RX_DMA_ENABLED
+	u8 bufferIndex = (dmaRxActiveIndex ^ 1);
+	u32 readyLength = dmaRxReadyLengths[bufferIndex];
+	if (readyLength > 0)
+	{
+		DebugUartProcessRxBytes(&dmaRxBuffers[bufferIndex][0], readyLength);
+		dmaRxReadyLengths[bufferIndex] = 0;
+	}
+	#endif
+	
+	if (!outputHeld && FifoLength(DebugFifoHeld) > 0)
+	{
+		//In batches so interrupts are never off for long (DebugFifoHeld is only touched by the main loop)
+		u8 batch[DEBUG_INPUT_BATCH_SIZE];
+		while (FifoLength(DebugFifoHeld) > 0 && DebugUartTxSpace() >= sizeof(batch))
+		{
+			u32 batchLength = 0;
+			while (batchLength < sizeof(batch) && FifoLength(DebugFifoHeld) > 0) { batch[batchLength++] = FifoPop(DebugFifoHeld); }
+			DebugUartTxPutBytes(batch, batchLength);
+		}
+		if (FifoLength(DebugFifoHeld) == 0 && heldDroppedCount > 0)
+		{
+			PrintLine_W("%u chars of output were dropped during a raw transfer", heldDroppedCount);
+			heldDroppedCount = 0;
+		}
+	}
+	
 	if (debugOverflow)
 	{
 		if (FifoLength(DebugFifoTx) == 0)
@@ -342,61 +661,169 @@ void DebugUartUpdate()
 			DebugUartTxPut('=');
 			DebugUartTxPut('\n');
 			DebugUartTxPut('\n');
-			DebugOutputBackoff = DEBUG_OVERFLOW_BACKOFF;
+			SoftTimerStartOneShot(&debugBackoffTimer, DEBUG_OVERFLOW_BACKOFF);
 			debugOverflow = false;
 		}
 	}
 }
 
+//NOTE: Called from TickTimerIsr every millisecond (or less often in tickless mode)
+//Returns true while received bytes are still waiting to be handed over, the tick timer
+//keeps 1ms ticks going until then so that DEBUG_RX_IDLE_TIMEOUT means what it says
+bool DebugUartRxIdleTick(u32 elapsedMs)
+{
+	#if DEBUG_RX_DMA_ENABLED
+	u32 dmaPntr = DBG_DMA_DPTR;
+	if (dmaPntr > 0 && dmaPntr == dmaRxLastPntr)
+	{
+		rxIdleTime += elapsedMs;
+		if (rxIdleTime >= DEBUG_RX_IDLE_TIMEOUT)
+		{
+			//The line went idle part way through a buffer. Kick the DMA ISR so it hands over what we have so far
+			DebugUartRxIdleFlushCount++;
+			#if ISR_STATS_ENABLED
+			IsrStatsMark(rxForcedCount); rxForcedPending = true;
+			#endif
+			DBG_DMA_INTSET = DBG_DMA_INTMASK;
+			rxIdleTime = 0;
+		}
+	}
+	else
+	{
+		rxIdleTime = 0;
+	}
+	dmaRxLastPntr = dmaPntr;
+	return (dmaPntr > 0);
+	#elif DEBUG_RX_COALESCE_ENABLED
+	if (DBG_UART_STAbits.URXDA)
+	{
+		rxIdleTime += elapsedMs;
+		if (rxIdleTime >= DEBUG_RX_IDLE_TIMEOUT)
+		{
+			//The bytes waiting in the hardware FIFO never reached the interrupt threshold so kick the Rx ISR ourselves
+			DebugUartRxIdleFlushCount++;
+			#if ISR_STATS_ENABLED
+			IsrStatsMark(rxForcedCount); rxForcedPending = true;
+			#endif
+			DBG_UART_RXINTSET = DBG_UART_RXINTMASK;
+			rxIdleTime = 0;
+		}
+	}
+	else
+	{
+		rxIdleTime = 0;
+		if (!rxSinceLastTick)
+		{
+			//The line has been quiet for a whole tick so go back to interrupting on every byte. Otherwise the
+			//first few bytes of the next burst could sit in the FIFO until the next tick, which might be ~20ms away
+			DBG_UART_STACLR = DBG_UART_BITMASK(STA, URXISEL);
+			return false;
+		}
+	}
+	//Bytes are coming in so only interrupt when the FIFO is half full. The 1ms ticks we ask for flush the rest
+	rxSinceLastTick = false;
+	DBG_UART_STASET = DBG_UART_BITSET(STA, URXISEL, DEBUG_RX_INT_MODE);
+	return true;
+	#else
+	return false;
+	#endif
+}
+
 // +--------------------------------------------------------------+
 // |                    Debug UART Receive ISR                    |
 // +--------------------------------------------------------------+
 void __ISR(DBG_UART_RXVECTOR, ipl1AUTO) DebugUartRxIsr()
 {
+	#if ISR_STATS_ENABLED
+	if (rxForcedPending) { IsrStatsRecord(IsrStatId_DebugRx, _CP0_GET_COUNT() - rxForcedCount); rxForcedPending = false; }
+	#endif
+	
 	u8 newByte;
+	u32 numErrors = 0;
+	DebugUartRxIsrCount++;
 	
 	//While Rx Data Available
 	while (DBG_UART_STAbits.URXDA)
 	{
+		DebugUartRxByteCount++;
 		bool parityError = (DBG_UART_STAbits.PERR != 0);
 		bool framingError = (DBG_UART_STAbits.FERR != 0);
 		newByte = DBG_UART_RXREG;
 		
 		if (!parityError && !framingError)
 		{
-			if ((newByte >= ' ' && newByte <= '~') || newByte == '\n' || newByte == '\t')
-			{
-				FifoPushHard(DebugFifoRx, newByte); //Push it on the FIFO to be processed later
-				#if DEBUG_ECHO_INPUT_CHARACTERS
-				FifoPush(DebugFifoTx, newByte);
-				DBG_UART_TXINTEN = ENABLED;
-				#endif
-			}
-			else if (newByte != '\b' && newByte != '\r')
-			{
-				#if DEBUG_ECHO_INPUT_CHARACTERS
-				FifoPush(DebugFifoTx, '?');
-				DBG_UART_TXINTEN = ENABLED;
-				#endif
-			}
+			if (!FifoPush(DebugFifoRxRaw, newByte)) { DebugUartRxOverflowCount++; }
 		}
 		else
 		{
-			#if DEBUG_ECHO_INPUT_CHARACTERS
-			FifoPush(DebugFifoTx, '!');
-			DBG_UART_TXINTEN = ENABLED;
-			#endif
+			numErrors++; //DebugUartErrIsr does the counting, we just let the main loop know to echo a '!'
 		}
 	}
 	
+	if (numErrors > 0) { WorkQueuePost(DebugUartEchoRxErrors, numErrors); }
+	rxIdleTime = 0;
+	#if (DEBUG_RX_COALESCE_ENABLED && !DEBUG_RX_DMA_ENABLED)
+	rxSinceLastTick = true;
+	#endif
+	SchedulerWake();
 	DBG_UART_RXINTFLAG = CLEARED;
 }
 
+#if DEBUG_RX_DMA_ENABLED
+// +--------------------------------------------------------------+
+// |                     Debug UART Rx DMA ISR                    |
+// +--------------------------------------------------------------+
+void __ISR(DBG_DMA_VECTOR, ipl1AUTO) DebugUartRxDmaIsr()
+{
+	#if ISR_STATS_ENABLED
+	if (rxForcedPending) { IsrStatsRecord(IsrStatId_DebugRx, _CP0_GET_COUNT() - rxForcedCount); rxForcedPending = false; }
+	#endif
+	
+	DBG_DMA_CONbits.CHEN = DISABLED;
+	while (DBG_DMA_CONbits.CHBUSY) { }
+	
+	//NOTE: The destination pointer resets to 0 when the block completes, otherwise this is an idle-line flush
+	u32 length = DBG_DMA_INTbits.CHBCIF ? DEBUG_RX_DMA_BUFFER_SIZE : DBG_DMA_DPTR;
+	DebugUartRxIsrCount++;
+	DebugUartRxByteCount += length;
+	
+	if (length > 0)
+	{
+		u8 otherIndex = (dmaRxActiveIndex ^ 1);
+		if (dmaRxReadyLengths[otherIndex] == 0)
+		{
+			dmaRxReadyLengths[dmaRxActiveIndex] = length;
+			dmaRxActiveIndex = otherIndex;
+		}
+		else
+		{
+			//The main loop hasn't drained the other buffer yet. Drop what we just received and reuse the active buffer
+			DebugUartRxOverflowCount++;
+		}
+		DBG_DMA_DSA = KVA_TO_PA(&dmaRxBuffers[dmaRxActiveIndex][0]); //Writing DSA resets the channel pointers
+	}
+	
+	dmaRxLastPntr = 0;
+	rxIdleTime = 0;
+	SchedulerWake();
+	DBG_DMA_INT &= 0xFFFF0000; //Clear the channel flags but leave the enables alone
+	DBG_DMA_INTFLAG = CLEARED;
+	DBG_DMA_CONbits.CHEN = ENABLED;
+	
+	//Bytes that arrived while the channel was disabled are waiting in the UART FIFO
+	if (DBG_UART_STAbits.URXDA) { DBG_DMA_ECONbits.CFORCE = 1; }
+}
+#endif
+
 // +--------------------------------------------------------------+
 // |                   Debug UART Transmit ISR                    |
 // +--------------------------------------------------------------+
 void __ISR(DBG_UART_TXVECTOR, ipl1AUTO) DebugUartTxIsr()
 {
+	#if ISR_STATS_ENABLED
+	if (txArmedPending) { IsrStatsRecord(IsrStatId_DebugTx, _CP0_GET_COUNT() - txArmedCount); txArmedPending = false; }
+	#endif
+	
 	//While data to send and Hardware FIFO is not full
 	while (!DBG_UART_STAbits.UTXBF && FifoLength(DebugFifoTx) > 0)
 	{
@@ -404,7 +831,11 @@ void __ISR(DBG_UART_TXVECTOR, ipl1AUTO) DebugUartTxIsr()
 		DBG_UART_TXREG = nextByte;
 	}
 	
-	if (FifoLength(DebugFifoTx) == 0) { DBG_UART_TXINTEN = DISABLED; }
+	if (FifoLength(DebugFifoTx) == 0)
+	{
+		DBG_UART_TXINTEN = DISABLED;
+		SchedulerWake(); //Anything waiting on DebugUartTxIdle can carry on now
+	}
 	DBG_UART_TXINTFLAG = CLEARED;
 }
 
@@ -413,6 +844,8 @@ void __ISR(DBG_UART_TXVECTOR, ipl1AUTO) DebugUartTxIsr()
 // +--------------------------------------------------------------+
 void __ISR(DBG_UART_ERRVECTOR, ipl1AUTO) DebugUartErrIsr()
 {
+	DebugUartRxErrorCount++;
+	if (DBG_UART_STAbits.OERR) { rxOverrunCount++; WorkQueuePost(DebugUartReportRxOverrun, rxOverrunCount); }
 	DBG_UART_STAbits.PERR = CLEARED;
 	DBG_UART_STAbits.FERR = CLEARED;
 	DBG_UART_STAbits.OERR = CLEARED;
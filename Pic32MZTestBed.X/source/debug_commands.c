@@ -13,6 +13,177 @@ Description:
 #include "debug.h"
 #include "tick_timer.h"
 #include "helpers.h"
+#include "jobs.h"
+#include "soft_timers.h"
+#include "isr_stats.h"
+#include "scheduler.h"
+#include "work_queue.h"
+#include "inputs.h"
+#include "debounce.h"
+#include "gpio.h"
+#include "waveform.h"
+#include "logic_analyzer.h"
+#include "bench.h"
+#include "soft_pwm.h"
+#include "oc_pwm.h"
+#include "input_capture.h"
+#include "edge_log.h"
+
+// +--------------------------------------------------------------+
+// |                     Private Definitions                      |
+// +--------------------------------------------------------------+
+#define DUMP_HEX_BYTES_PER_LINE  16
+#define DUMP_BINARY_BLOCK_SIZE   256
+#define DUMP_BINARY_HEADER_SIZE  32 //chars, "BIN [address] [length]"
+
+typedef enum
+{
+	DumpMode_Hex            = 0x00,
+	DumpMode_BinaryWaiting  = 0x01, //for another raw transfer to give up the UART
+	DumpMode_BinarySending  = 0x02, //output is held until the CRC has gone out
+} DumpMode_t;
+
+// +--------------------------------------------------------------+
+// |                         Command Jobs                         |
+// +--------------------------------------------------------------+
+static JobResult_t ResetJob(Job_t* job)
+{
+	if (job->killRequested) { return JobResult_Done; }
+	
+	JobBegin(job);
+	//Wait for the "Resetting..." message to finish going out without blocking the main loop
+	JobWaitUntil(job, DebugUartTxIdle());
+	MicroReset();
+	JobEnd(job);
+}
+
+//SFRs need to be read a whole word at a time, everything else can be copied byte by byte
+static void ReadMemory(u32 address, u8* bufferOut, u32 length)
+{
+	if (MicroIsSfrAddress(address))
+	{
+		Assert((address % 4) == 0 && (length % 4) == 0);
+		u32 wIndex;
+		for (wIndex = 0; wIndex < length/4; wIndex++)
+		{
+			u32 word = *((volatile const u32*)(address + wIndex*4));
+			memcpy(&bufferOut[wIndex*4], &word, sizeof(u32));
+		}
+	}
+	else
+	{
+		memcpy(bufferOut, (const void*)address, length);
+	}
+}
+
+//args[0] = current address, args[1] = bytes remaining, args[2] = DumpMode_t, args[3] = running CRC
+static JobResult_t DumpJob(Job_t* job)
+{
+	u8 block[DUMP_BINARY_BLOCK_SIZE];
+	char hexBuffer[DUMP_HEX_BYTES_PER_LINE*2 + 1];
+	bool binaryMode = (job->args[2] != DumpMode_Hex);
+	
+	if (job->killRequested)
+	{
+		if (job->args[2] == DumpMode_BinarySending) { DebugUartReleaseOutput(); }
+		if (binaryMode) { WriteLine_I(""); }
+		return JobResult_Done;
+	}
+	
+	if (job->args[2] == DumpMode_BinaryWaiting)
+	{
+		//Hold every other bit of output from the BIN line to the CRC so nothing lands in the middle of the data.
+		//The BIN line is written raw too, so it can't end up behind text that a VCD upload held back
+		char headerBuffer[DUMP_BINARY_HEADER_SIZE];
+		if (DebugUartTxSpace() < sizeof(headerBuffer) || !DebugUartHoldOutput()) { return JobResult_InProgress; }
+		u32 headerLength = (u32)snprintf(headerBuffer, sizeof(headerBuffer), "BIN %08X %u\n", job->args[0], job->args[1]);
+		DebugUartTxPutBytes((const u8*)headerBuffer, headerLength);
+		job->args[2] = DumpMode_BinarySending;
+	}
+	
+	if (binaryMode)
+	{
+		u32 txSpace = DebugUartTxSpace();
+		while (job->args[1] > 0 && txSpace > 0)
+		{
+			u32 blockSize = job->args[1];
+			if (blockSize > sizeof(block)) { blockSize = sizeof(block); }
+			if (blockSize > txSpace) { blockSize = txSpace; }
+			if (MicroIsSfrAddress(job->args[0])) { blockSize -= (blockSize % 4); if (blockSize == 0) { break; } }
+			
+			ReadMemory(job->args[0], block, blockSize);
+			DebugUartTxPutBytes(block, blockSize);
+			job->args[3] = CalculateCrc32(job->args[3], block, blockSize);
+			job->args[0] += blockSize;
+			job->args[1] -= blockSize;
+			txSpace -= blockSize;
+		}
+		
+		if (job->args[1] == 0 && txSpace >= sizeof(u32))
+		{
+			u32 crc = job->args[3];
+			u8 crcBytes[4] = { (u8)(crc >> 0), (u8)(crc >> 8), (u8)(crc >> 16), (u8)(crc >> 24) };
+			DebugUartTxPutBytes(crcBytes, sizeof(crcBytes));
+			DebugUartReleaseOutput();
+			WriteLine_I("");
+			PrintLine_I("CRC32: %08X", crc);
+			return JobResult_Done;
+		}
+	}
+	else
+	{
+		while (job->args[1] > 0 && DebugUartTxSpace() >= DEBUG_PRINT_BUFFER_SIZE/4)
+		{
+			u32 lineSize = job->args[1];
+			if (lineSize > DUMP_HEX_BYTES_PER_LINE) { lineSize = DUMP_HEX_BYTES_PER_LINE; }
+			
+			ReadMemory(job->args[0], block, lineSize);
+			HexToString(block, lineSize, hexBuffer);
+			PrintLine_I("%08X: %s", job->args[0], hexBuffer);
+			job->args[0] += lineSize;
+			job->args[1] -= lineSize;
+		}
+		if (job->args[1] == 0) { return JobResult_Done; }
+	}
+	
+	return JobResult_InProgress;
+}
+
+//args[0] = requested baud rate
+static JobResult_t BaudJob(Job_t* job)
+{
+	if (job->killRequested) { return JobResult_Done; }
+	
+	JobBegin(job);
+	JobWaitUntil(job, DebugUartTxIdle());
+	u32 actualBaudRate = DebugUartSetBaudRate(job->args[0]);
+	PrintLine_I("Baud rate is now %u (requested %u)", actualBaudRate, job->args[0]);
+	JobEnd(job);
+}
+
+//args[0] = measurement length in ms, args[1] = starting tick, args[2]/args[3] = starting cycle count (low/high)
+static JobResult_t ClockJob(Job_t* job)
+{
+	if (job->killRequested) { return JobResult_Done; }
+	
+	u32 tickMs;
+	u64 cycles;
+	JobBegin(job);
+	TickTimerGetLastTick(&tickMs, &cycles);
+	job->args[1] = tickMs;
+	job->args[2] = (u32)cycles;
+	job->args[3] = (u32)(cycles >> 32);
+	JobWaitUntil(job, TimeSinceMs(job->args[1]) > job->args[0]);
+	
+	TickTimerGetLastTick(&tickMs, &cycles);
+	u32 elapsedMs = tickMs - job->args[1];
+	u64 elapsedCycles = cycles - (((u64)job->args[3] << 32) | job->args[2]);
+	u32 periodNs = (u32)((elapsedCycles * 1000000) / ((u64)MICRO_ONE_MS_COUNT * elapsedMs));
+	PrintLine_I("Measured %ums of ticks against %u core cycles", elapsedMs, (u32)elapsedCycles);
+	PrintLine_I("Tick period: %u.%03uus", periodNs / 1000, periodNs % 1000);
+	PrintLine_I("Drift: %d ppm", TickTimerCalculateDriftPpm(elapsedMs, elapsedCycles));
+	JobEnd(job);
+}
 
 // +--------------------------------------------------------------+
 // |                       Public Functions                       |
@@ -30,8 +201,41 @@ void HandleDebugCommand(const char* commandStr)
 		WriteLine_I("status : Prints out some information about the state of the unit");
 		WriteLine_I("test : Used for random tests");
 		WriteLine_I("reset : Reset the controller");
-		WriteLine_I("buttons : Prints out the current state of the buttons");
-		WriteLine_I("pin [number] [value] : Manually change one of the test pins to 1 (HIGH) or 0 (LOW) output value");
+		WriteLine_I("buttons : Prints out the current (debounced) state of the buttons");
+		WriteLine_I("edgelog : Prints the button edges (with cycle timestamps) recorded since the last time, as many as the UART has room for");
+		WriteLine_I("edgelog stream / edgelog stop / edgelog clear : Keeps printing the edge log in batches, stops that, or throws away what's in it");
+		WriteLine_I("debounce : Prints the debounced state of each port and the edges nothing has taken yet");
+		WriteLine_I("pin [number/name] [value] : Drives a test pin (1-6) or any named output (ex. TestLed1) to 1 (HIGH), 0 (LOW) or t (toggle)");
+		WriteLine_I("pwm : Prints the duty cycle of each software PWM channel");
+		WriteLine_I("pwm [number/name] [duty/off] : Gives a test pin (1-6) or LED (ex. TestLed1) a duty cycle from 0-255, or hands it back to the pin command");
+		WriteLine_I("ocpwm : Prints the frequency and duty cycle of each output compare PWM header pin");
+		WriteLine_I("ocpwm freq [hz] : Changes the frequency shared by all the output compare PWM pins");
+		PrintLine_I("ocpwm [name] [duty/off] : Gives OC1-OC%u (or its pin, ex. RD0) a duty cycle in tenths of a percent (0-%u), or turns it off", OcPwm_NumChannels, OC_PWM_MAX_DUTY);
+		WriteLine_I("capture : Prints the frequency, duty and pulse widths measured by the last input capture");
+		PrintLine_I("capture start [name] {edges} : Timestamps edges on IC1/IC2/IC3/IC6 (or its pin, ex. RD1) until stopped or {edges} (max %u) are captured", CAPTURE_BUFFER_SIZE);
+		WriteLine_I("capture hist [period/high/low] / capture stop : Prints a histogram of the last capture or stops it");
+		WriteLine_I("wave : Lists the waveform steps loaded for TestPin1-6");
+		WriteLine_I("wave add [mask] [value] [delayUs] : Adds a step that drives the pins in mask (hex, bit 0 = TestPin1) then waits");
+		WriteLine_I("wave play {loops} / wave stop / wave clear : Plays the waveform (0 loops = forever), stops it or removes all steps");
+		WriteLine_I("logic : Prints the state of the logic analyzer capture");
+		WriteLine_I("logic start [port] [mask] [rateHz] {samples} : Samples the pins in mask (hex) of PORTx until stopped, full or {samples} taken");
+		WriteLine_I("logic trig [none/edge/pattern] {mask} {value} : Sets what the next capture waits for before it starts");
+		WriteLine_I("logic stop / logic vcd : Stops the capture or sends what was captured to the host as a VCD file");
+		WriteLine_I("bench {toggle/isr/dma/memcpy} : Measures GPIO toggle rates, interrupt latency and memcpy speed (all of them by default)");
+		WriteLine_I("uart [reset] : Prints (or clears) the debug UART receive interrupt statistics");
+		WriteLine_I("isrstat [reset] : Prints (or clears) the interrupt latency histograms");
+		WriteLine_I("echo [on/off] : Turns the echo of received characters on or off");
+		WriteLine_I("peek [address] {1/2/4} : Reads a byte, half-word or word (default) from RAM, flash or SFR space");
+		WriteLine_I("poke [address] [value] {1/2/4} : Writes a byte, half-word or word (default) to RAM or SFR space");
+		WriteLine_I("fill [address] [length] [byte] : Fills a range of RAM with a byte value");
+		WriteLine_I("dump [address] [length] {bin} : Dumps memory as hex, or as raw binary followed by a little-endian CRC32");
+		WriteLine_I("baud [rate] : Changes the debug UART baud rate");
+		WriteLine_I("clock {seconds} : Measures the tick timer against the core clock and reports the drift in ppm");
+		WriteLine_I("tickless [on/off] : Switches the tick timer between tickless and periodic (1ms) interrupts");
+		WriteLine_I("tasks [reset] : Prints (or clears) the run time and overrun statistics for each scheduler task");
+		WriteLine_I("workq [reset] : Prints (or clears) the deferred work queue statistics");
+		WriteLine_I("jobs : Lists the long running commands that are currently in progress");
+		WriteLine_I("kill [id] : Stops one of the jobs listed by the jobs command");
 	}
 	
 	// +==============================+
@@ -40,7 +244,12 @@ void HandleDebugCommand(const char* commandStr)
 	else if (strcmp(commandStr, "status") == 0)
 	{
 		PrintLine_N("PIC32MZ Test Bed v%u.%u(%u)", Version.major, Version.minor, Version.build);
-		Write_I("Time: "); PrintFormattedMilliseconds(OutputLevel_Info, TickCounterMs); WriteLine_I("");
+		Write_I("Time: "); PrintFormattedMilliseconds(OutputLevel_Info, TickTimerGetMs()); WriteLine_I("");
+		PrintLine_I("Soft Timers: %u active", SoftTimersNumActive());
+		PrintLine_I("Last Command: %us ago", SecCountup(LastCommand));
+		PrintLine_I("Tick Timer: %s, %u interrupts/sec", TickTimerIsTickless() ? "Tickless" : "Periodic", TickTimerIsrsLastSecond);
+		u32 idlePermille = SchedulerGetIdlePermille();
+		PrintLine_I("CPU: %u.%u%% idle", idlePermille / 10, idlePermille % 10);
 	}
 	
 	// +==============================+
@@ -58,8 +267,245 @@ void HandleDebugCommand(const char* commandStr)
 	else if (strcmp(commandStr, "reset") == 0)
 	{
 		WriteLine_I("Resetting...");
-		DebugUartFlush();
-		MicroReset();
+		JobStart("reset", ResetJob);
+	}
+	
+	// +==============================+
+	// |         uart [reset]         |
+	// +==============================+
+	else if (strcmp(commandStr, "uart") == 0)
+	{
+		u32 numInterrupts = DebugUartRxIsrCount;
+		u32 numBytes = DebugUartRxByteCount;
+		PrintLine_I("Rx: %u bytes in %u interrupts (%u idle flushes)", numBytes, numInterrupts, DebugUartRxIdleFlushCount);
+		PrintLine_I("Rx: %u errors, %u overflows", DebugUartRxErrorCount, DebugUartRxOverflowCount);
+		if (numBytes > 0)
+		{
+			PrintLine_I("Rx: %u interrupts per KB", (u32)(((u64)numInterrupts * 1024) / numBytes));
+		}
+	}
+	else if (strcmp(commandStr, "uart reset") == 0)
+	{
+		DebugUartRxIsrCount = 0;
+		DebugUartRxByteCount = 0;
+		DebugUartRxIdleFlushCount = 0;
+		DebugUartRxErrorCount = 0;
+		DebugUartRxOverflowCount = 0;
+		WriteLine_I("Rx statistics cleared");
+	}
+	
+	// +==============================+
+	// |       isrstat [reset]        |
+	// +==============================+
+	else if (strcmp(commandStr, "isrstat") == 0)
+	{
+		IsrStatsPrint();
+	}
+	else if (strcmp(commandStr, "isrstat reset") == 0)
+	{
+		IsrStatsReset();
+		WriteLine_I("ISR statistics cleared");
+	}
+	
+	// +==============================+
+	// |        echo [on/off]         |
+	// +==============================+
+	else if (strcmp(commandStr, "echo on") == 0 || strcmp(commandStr, "echo off") == 0)
+	{
+		DebugUartSetEcho(strcmp(commandStr, "echo on") == 0);
+		PrintLine_I("Echo %s", DebugUartGetEcho() ? "Enabled" : "Disabled");
+	}
+	
+	// +==============================+
+	// |   peek [address] {width}     |
+	// +==============================+
+	else if (commandLength >= 5 && strncmp(commandStr, "peek ", 5) == 0)
+	{
+		const char* parts[3];
+		u32 partLengths[3];
+		u32 numParts = SplitNtString(&commandStr[5], ' ', &parts[0], &partLengths[0], ArrayCount(parts));
+		if (numParts < 1 || numParts > 2) { WriteLine_E("Usage: peek [address] {1/2/4}"); return; }
+		u32 address = 0;
+		if (!TryParseAddress(parts[0], partLengths[0], &address)) { PrintLine_E("Invalid address given \"%.*s\"", partLengths[0], parts[0]); return; }
+		i32 width = 4;
+		if (numParts >= 2 && (!TryParseInt32(parts[1], partLengths[1], &width) || (width != 1 && width != 2 && width != 4))) { PrintLine_E("Invalid width given \"%.*s\"", partLengths[1], parts[1]); return; }
+		if ((address % width) != 0) { PrintLine_E("Address must be aligned to %d bytes", width); return; }
+		if (!MicroIsValidMemoryRange(address, (u32)width, false)) { PrintLine_E("Can't read from 0x%08X", address); return; }
+		
+		u32 value = 0;
+		if (width == 1) { value = *((volatile const u8*)address); }
+		else if (width == 2) { value = *((volatile const u16*)address); }
+		else { value = *((volatile const u32*)address); }
+		PrintLine_I("[%08X] = 0x%0*X", address, width*2, value);
+	}
+	
+	// +==============================+
+	// |poke [address] [value] {width}|
+	// +==============================+
+	else if (commandLength >= 5 && strncmp(commandStr, "poke ", 5) == 0)
+	{
+		const char* parts[4];
+		u32 partLengths[4];
+		u32 numParts = SplitNtString(&commandStr[5], ' ', &parts[0], &partLengths[0], ArrayCount(parts));
+		if (numParts < 2 || numParts > 3) { WriteLine_E("Usage: poke [address] [value] {1/2/4}"); return; }
+		u32 address = 0;
+		if (!TryParseAddress(parts[0], partLengths[0], &address)) { PrintLine_E("Invalid address given \"%.*s\"", partLengths[0], parts[0]); return; }
+		u32 value = 0;
+		if (!TryParseAddress(parts[1], partLengths[1], &value)) { PrintLine_E("Invalid hex value given \"%.*s\"", partLengths[1], parts[1]); return; }
+		i32 width = 4;
+		if (numParts >= 3 && (!TryParseInt32(parts[2], partLengths[2], &width) || (width != 1 && width != 2 && width != 4))) { PrintLine_E("Invalid width given \"%.*s\"", partLengths[2], parts[2]); return; }
+		if ((address % width) != 0) { PrintLine_E("Address must be aligned to %d bytes", width); return; }
+		if (!MicroIsValidMemoryRange(address, (u32)width, true)) { PrintLine_E("Can't write to 0x%08X", address); return; }
+		
+		if (width == 1) { *((volatile u8*)address) = (u8)value; }
+		else if (width == 2) { *((volatile u16*)address) = (u16)value; }
+		else { *((volatile u32*)address) = value; }
+		PrintLine_I("[%08X] <- 0x%0*X", address, width*2, value);
+	}
+	
+	// +==============================+
+	// | fill [address] [len] [byte]  |
+	// +==============================+
+	else if (commandLength >= 5 && strncmp(commandStr, "fill ", 5) == 0)
+	{
+		const char* parts[4];
+		u32 partLengths[4];
+		u32 numParts = SplitNtString(&commandStr[5], ' ', &parts[0], &partLengths[0], ArrayCount(parts));
+		if (numParts != 3) { WriteLine_E("Usage: fill [address] [length] [byte]"); return; }
+		u32 address = 0;
+		if (!TryParseAddress(parts[0], partLengths[0], &address)) { PrintLine_E("Invalid address given \"%.*s\"", partLengths[0], parts[0]); return; }
+		i32 length = 0;
+		if (!TryParseInt32(parts[1], partLengths[1], &length) || length <= 0) { PrintLine_E("Invalid length given \"%.*s\"", partLengths[1], parts[1]); return; }
+		u8 value = 0;
+		if (!TryParseHex8(parts[2], partLengths[2], &value)) { PrintLine_E("Invalid hex byte given \"%.*s\"", partLengths[2], parts[2]); return; }
+		if (!MicroIsValidMemoryRange(address, (u32)length, true) || MicroIsSfrAddress(address)) { PrintLine_E("Can't fill %d bytes at 0x%08X", length, address); return; }
+		
+		memset((void*)address, value, (u32)length);
+		PrintLine_I("Filled %d bytes at %08X with 0x%02X", length, address, value);
+	}
+	
+	// +==============================+
+	// | dump [address] [len] {bin}   |
+	// +==============================+
+	else if (commandLength >= 5 && strncmp(commandStr, "dump ", 5) == 0)
+	{
+		const char* parts[4];
+		u32 partLengths[4];
+		u32 numParts = SplitNtString(&commandStr[5], ' ', &parts[0], &partLengths[0], ArrayCount(parts));
+		if (numParts < 2 || numParts > 3) { WriteLine_E("Usage: dump [address] [length] {bin}"); return; }
+		u32 address = 0;
+		if (!TryParseAddress(parts[0], partLengths[0], &address)) { PrintLine_E("Invalid address given \"%.*s\"", partLengths[0], parts[0]); return; }
+		i32 length = 0;
+		if (!TryParseInt32(parts[1], partLengths[1], &length) || length <= 0) { PrintLine_E("Invalid length given \"%.*s\"", partLengths[1], parts[1]); return; }
+		bool binaryMode = false;
+		if (numParts >= 3)
+		{
+			if (partLengths[2] == 3 && strncmp(parts[2], "bin", 3) == 0) { binaryMode = true; }
+			else if (partLengths[2] == 3 && strncmp(parts[2], "hex", 3) == 0) { binaryMode = false; }
+			else { PrintLine_E("Unknown dump mode \"%.*s\"", partLengths[2], parts[2]); return; }
+		}
+		if (!MicroIsValidMemoryRange(address, (u32)length, false)) { PrintLine_E("Can't read %d bytes at 0x%08X", length, address); return; }
+		if (MicroIsSfrAddress(address) && ((address % 4) != 0 || (length % 4) != 0)) { WriteLine_E("SFR dumps must be word aligned"); return; }
+		
+		Job_t* job = JobStart("dump", DumpJob);
+		if (job != nullptr)
+		{
+			job->args[0] = address;
+			job->args[1] = (u32)length;
+			job->args[2] = binaryMode ? DumpMode_BinaryWaiting : DumpMode_Hex;
+			job->args[3] = 0;
+			//NOTE: In binary mode DumpJob starts with a "BIN [address] [length]" line.
+			//      The host should read exactly [length] bytes after it, followed by 4 CRC bytes
+		}
+	}
+	
+	// +==============================+
+	// |         baud [rate]          |
+	// +==============================+
+	else if (commandLength >= 5 && strncmp(commandStr, "baud ", 5) == 0)
+	{
+		i32 baudRate = 0;
+		if (!TryParseInt32(&commandStr[5], commandLength-5, &baudRate) || baudRate < 1200) { PrintLine_E("Invalid baud rate given \"%s\"", &commandStr[5]); return; }
+		Job_t* job = JobStart("baud", BaudJob);
+		if (job != nullptr)
+		{
+			PrintLine_I("Switching to %d baud", baudRate);
+			job->args[0] = (u32)baudRate;
+		}
+	}
+	
+	// +==============================+
+	// |       clock {seconds}        |
+	// +==============================+
+	else if (strcmp(commandStr, "clock") == 0 || strncmp(commandStr, "clock ", 6) == 0)
+	{
+		i32 numSeconds = 5;
+		if (commandLength > 6 && (!TryParseInt32(&commandStr[6], commandLength - 6, &numSeconds) || numSeconds <= 0 || numSeconds > 40))
+		{
+			PrintLine_E("Invalid number of seconds \"%s\". Must be 1-40", &commandStr[6]);
+			return;
+		}
+		
+		Job_t* job = JobStart("clock", ClockJob);
+		if (job != nullptr)
+		{
+			PrintLine_I("Tick timer PR9 = %u (%s). Measuring for %ds...", PR9, TickTimerIsTickless() ? "Tickless" : "Periodic", numSeconds);
+			job->args[0] = (u32)numSeconds * 1000;
+		}
+	}
+	
+	// +==============================+
+	// |      tickless [on/off]       |
+	// +==============================+
+	else if (strcmp(commandStr, "tickless on") == 0 || strcmp(commandStr, "tickless off") == 0)
+	{
+		TickTimerSetTickless(strcmp(commandStr, "tickless on") == 0);
+		PrintLine_I("Tick timer is now %s", TickTimerIsTickless() ? "Tickless" : "Periodic");
+	}
+	
+	// +==============================+
+	// |        tasks [reset]         |
+	// +==============================+
+	else if (strcmp(commandStr, "tasks") == 0)
+	{
+		SchedulerPrintTasks();
+	}
+	else if (strcmp(commandStr, "tasks reset") == 0)
+	{
+		SchedulerResetStats();
+		WriteLine_I("Task statistics cleared");
+	}
+	
+	// +==============================+
+	// |        workq [reset]         |
+	// +==============================+
+	else if (strcmp(commandStr, "workq") == 0)
+	{
+		PrintLine_I("Work Queue: %u/%u items (max %u)", WorkQueueDepth(), WORK_QUEUE_SIZE, WorkQueueMaxDepth);
+		PrintLine_I("Work Queue: %u posted, %u executed, %u dropped", WorkQueueNumPosted, WorkQueueNumExecuted, WorkQueueNumDropped);
+	}
+	else if (strcmp(commandStr, "workq reset") == 0)
+	{
+		WorkQueueResetStats();
+		WriteLine_I("Work queue statistics cleared");
+	}
+	
+	// +==============================+
+	// |             jobs             |
+	// +==============================+
+	else if (strcmp(commandStr, "jobs") == 0)
+	{
+		JobsPrintList();
+	}
+	
+	// +==============================+
+	// |          kill [id]           |
+	// +==============================+
+	else if (commandLength >= 5 && strncmp(commandStr, "kill ", 5) == 0)
+	{
+		i32 jobIdI32 = 0;
+		if (!TryParseInt32(&commandStr[5], commandLength-5, &jobIdI32) || jobIdI32 <= 0) { PrintLine_E("Invalid job id given \"%s\"", &commandStr[5]); return; }
+		if (!JobKill((u32)jobIdI32)) { PrintLine_E("No job with id %d is running", jobIdI32); return; }
 	}
 	
 	// +==============================+
@@ -67,40 +513,368 @@ void HandleDebugCommand(const char* commandStr)
 	// +==============================+
 	else if (strcmp(commandStr, "buttons") == 0)
 	{
-		bool btn1 = (TEST_BTN1_VALUE == LOW);
-		bool btn2 = (TEST_BTN2_VALUE == LOW);
-		bool btn3 = (TEST_BTN3_VALUE == LOW);
-		PrintLineAt(btn1 ? OutputLevel_Info : OutputLevel_Debug, "Button 1: %s", btn1 ? "Pressed" : "Released");
-		PrintLineAt(btn2 ? OutputLevel_Info : OutputLevel_Debug, "Button 2: %s", btn2 ? "Pressed" : "Released");
-		PrintLineAt(btn3 ? OutputLevel_Info : OutputLevel_Debug, "Button 3: %s", btn3 ? "Pressed" : "Released");
+		u32 iIndex;
+		for (iIndex = 0; iIndex < Input_NumInputs; iIndex++)
+		{
+			bool isDown = InputIsDown((Input_t)iIndex);
+			PrintLineAt(isDown ? OutputLevel_Info : OutputLevel_Debug, "%s: %s", GetInputName((Input_t)iIndex), isDown ? "Pressed" : "Released");
+		}
+		if (InputsEdgeOverflowCount > 0 || InputsEventOverflowCount > 0)
+		{
+			PrintLine_W("%u edges and %u events were dropped", InputsEdgeOverflowCount, InputsEventOverflowCount);
+		}
+	}
+	
+	// +==============================+
+	// |           edgelog            |
+	// +==============================+
+	else if (strcmp(commandStr, "edgelog") == 0)
+	{
+		u32 numPending = EdgeLogNumPending();
+		if (numPending == 0) { WriteLine_I("No edges recorded"); }
+		else
+		{
+			u32 numPrinted = EdgeLogPrint(0);
+			if (numPrinted < numPending) { PrintLine_I("%u more edges, run edgelog again", numPending - numPrinted); }
+		}
+		if (EdgeLogOverflowCount > 0) { PrintLine_W("%u edges were dropped because the log was full", EdgeLogOverflowCount); }
+	}
+	
+	// +==============================+
+	// |        edgelog stream        |
+	// +==============================+
+	else if (strcmp(commandStr, "edgelog stream") == 0)
+	{
+		if (EdgeLogStartStream()) { WriteLine_I("Streaming the edge log until \"edgelog stop\""); }
+	}
+	
+	// +==============================+
+	// |         edgelog stop         |
+	// +==============================+
+	else if (strcmp(commandStr, "edgelog stop") == 0)
+	{
+		if (!EdgeLogIsStreaming()) { WriteLine_E("The edge log isn't streaming"); return; }
+		EdgeLogStopStream();
+		WriteLine_I("Edge log stream stopped");
+	}
+	
+	// +==============================+
+	// |        edgelog clear         |
+	// +==============================+
+	else if (strcmp(commandStr, "edgelog clear") == 0)
+	{
+		EdgeLogClear();
+		WriteLine_I("Edge log cleared");
+	}
+	
+	// +==============================+
+	// |           debounce           |
+	// +==============================+
+	else if (strcmp(commandStr, "debounce") == 0)
+	{
+		DebouncePrintPorts();
 	}
 	
 	// +==============================+
-	// |     pin [number] [value]     |
+	// |  pin [number/name] [value]   |
 	// +==============================+
 	else if (commandLength >= 4 && strncmp(commandStr, "pin ", 4) == 0)
 	{
 		const char* parts[4];
 		u32 partLengths[4];
 		u32 numParts = SplitNtString(&commandStr[4], ' ', &parts[0], &partLengths[0], ArrayCount(parts));
-		if (numParts != 2 || partLengths[0] == 0 || partLengths[1] == 0) { WriteLine_E("Usage: pin [number] [value]"); return; }
+		if (numParts != 2 || partLengths[0] == 0 || partLengths[1] == 0) { WriteLine_E("Usage: pin [number/name] [value]"); return; }
+		Gpio_t pin = Gpio_NumPins;
 		i32 pinNumberI32 = 0;
-		if (!TryParseInt32(parts[0], partLengths[0], &pinNumberI32) || pinNumberI32 < 1 || pinNumberI32 > 6) { PrintLine_E("Invalid pin number given \"%.*s\"", partLengths[0], parts[0]); return; }
+		if (TryParseInt32(parts[0], partLengths[0], &pinNumberI32))
+		{
+			if (pinNumberI32 < 1 || pinNumberI32 > 6) { PrintLine_E("Invalid pin number given \"%.*s\"", partLengths[0], parts[0]); return; }
+			pin = (Gpio_t)(Gpio_TestPin1 + (pinNumberI32 - 1));
+		}
+		else if (!GpioFindByName(parts[0], partLengths[0], &pin)) { PrintLine_E("Unknown pin name given \"%.*s\"", partLengths[0], parts[0]); return; }
+		
+		if (partLengths[1] == 1 && parts[1][0] == 't')
+		{
+			GpioToggle(pin);
+			PrintLine_I("Toggled %s %s", GetGpioName(pin), GpioRead(pin) ? "HIGH" : "LOW");
+			return;
+		}
 		i32 valueI32 = 0;
 		if (!TryParseInt32(parts[1], partLengths[1], &valueI32) || valueI32 < 0 || valueI32 > 1) { PrintLine_E("Invalid value given \"%.*s\"", partLengths[1], parts[1]); return; }
 		
-		PrintLine_I("Setting TEST_PIN%d %s", pinNumberI32, (valueI32 > 0) ? "HIGH" : "LOW");
-		switch (pinNumberI32)
+		PrintLine_I("Setting %s %s", GetGpioName(pin), (valueI32 > 0) ? "HIGH" : "LOW");
+		GpioWrite(pin, (valueI32 > 0));
+	}
+	
+	// +==============================+
+	// |             pwm              |
+	// +==============================+
+	else if (strcmp(commandStr, "pwm") == 0)
+	{
+		SoftPwmPrintChannels();
+	}
+	
+	// +==============================+
+	// |  pwm [number/name] [duty]    |
+	// +==============================+
+	else if (commandLength >= 4 && strncmp(commandStr, "pwm ", 4) == 0)
+	{
+		const char* parts[4];
+		u32 partLengths[4];
+		u32 numParts = SplitNtString(&commandStr[4], ' ', &parts[0], &partLengths[0], ArrayCount(parts));
+		if (numParts != 2 || partLengths[0] == 0 || partLengths[1] == 0) { WriteLine_E("Usage: pwm [number/name] [duty/off]"); return; }
+		SoftPwmChannel_t channel = SoftPwm_NumChannels;
+		i32 pinNumberI32 = 0;
+		if (TryParseInt32(parts[0], partLengths[0], &pinNumberI32))
+		{
+			if (pinNumberI32 < 1 || pinNumberI32 > 6) { PrintLine_E("Invalid pin number given \"%.*s\"", partLengths[0], parts[0]); return; }
+			channel = (SoftPwmChannel_t)(SoftPwm_TestPin1 + (pinNumberI32 - 1));
+		}
+		else if (!SoftPwmFindByName(parts[0], partLengths[0], &channel)) { PrintLine_E("No PWM channel named \"%.*s\"", partLengths[0], parts[0]); return; }
+		
+		if (partLengths[1] == 3 && strncmp(parts[1], "off", 3) == 0)
+		{
+			SoftPwmRelease(channel);
+			WriteLine_I("PWM released");
+			return;
+		}
+		i32 dutyI32 = 0;
+		if (!TryParseInt32(parts[1], partLengths[1], &dutyI32) || dutyI32 < 0 || dutyI32 > SOFT_PWM_MAX_DUTY) { PrintLine_E("Invalid duty given \"%.*s\". Must be 0-%u", partLengths[1], parts[1], SOFT_PWM_MAX_DUTY); return; }
+		SoftPwmSetDuty(channel, (u8)dutyI32);
+		PrintLine_I("Duty set to %d/%u", dutyI32, SOFT_PWM_MAX_DUTY);
+	}
+	
+	// +==============================+
+	// |            ocpwm             |
+	// +==============================+
+	else if (strcmp(commandStr, "ocpwm") == 0)
+	{
+		OcPwmPrintChannels();
+	}
+	
+	// +==============================+
+	// |       ocpwm freq [hz]        |
+	// +==============================+
+	else if (commandLength >= 11 && strncmp(commandStr, "ocpwm freq ", 11) == 0)
+	{
+		i32 frequencyI32 = 0;
+		if (!TryParseInt32(&commandStr[11], commandLength - 11, &frequencyI32) || frequencyI32 <= 0) { PrintLine_E("Invalid frequency given \"%s\"", &commandStr[11]); return; }
+		if (OcPwmSetFrequency((u32)frequencyI32)) { PrintLine_I("PWM frequency set to %dHz", frequencyI32); }
+	}
+	
+	// +==============================+
+	// |    ocpwm [name] [duty]       |
+	// +==============================+
+	else if (commandLength >= 6 && strncmp(commandStr, "ocpwm ", 6) == 0)
+	{
+		const char* parts[4];
+		u32 partLengths[4];
+		u32 numParts = SplitNtString(&commandStr[6], ' ', &parts[0], &partLengths[0], ArrayCount(parts));
+		if (numParts != 2 || partLengths[0] == 0 || partLengths[1] == 0) { WriteLine_E("Usage: ocpwm [name] [duty/off]"); return; }
+		OcPwmChannel_t channel = OcPwm_NumChannels;
+		if (!OcPwmFindByName(parts[0], partLengths[0], &channel)) { PrintLine_E("No output compare PWM channel named \"%.*s\"", partLengths[0], parts[0]); return; }
+		
+		if (partLengths[1] == 3 && strncmp(parts[1], "off", 3) == 0)
 		{
-			case 1: TEST_PIN1_VALUE = (valueI32 > 0) ? HIGH : LOW; break;
-			case 2: TEST_PIN2_VALUE = (valueI32 > 0) ? HIGH : LOW; break;
-			case 3: TEST_PIN3_VALUE = (valueI32 > 0) ? HIGH : LOW; break;
-			case 4: TEST_PIN4_VALUE = (valueI32 > 0) ? HIGH : LOW; break;
-			case 5: TEST_PIN5_VALUE = (valueI32 > 0) ? HIGH : LOW; break;
-			case 6: TEST_PIN6_VALUE = (valueI32 > 0) ? HIGH : LOW; break;
-			default: Assert(false); break;
+			OcPwmRelease(channel);
+			WriteLine_I("PWM turned off");
+			return;
 		}
+		i32 dutyI32 = 0;
+		if (!TryParseInt32(parts[1], partLengths[1], &dutyI32) || dutyI32 < 0 || dutyI32 > OC_PWM_MAX_DUTY) { PrintLine_E("Invalid duty given \"%.*s\". Must be 0-%u", partLengths[1], parts[1], OC_PWM_MAX_DUTY); return; }
+		OcPwmSetDuty(channel, (u16)dutyI32);
+		PrintLine_I("Duty set to %d.%d%%", dutyI32 / 10, dutyI32 % 10);
+	}
+	
+	// +==============================+
+	// |           capture            |
+	// +==============================+
+	else if (strcmp(commandStr, "capture") == 0)
+	{
+		CapturePrintReport();
+	}
+	
+	// +==============================+
+	// | capture start [name] {edges} |
+	// +==============================+
+	else if (commandLength >= 14 && strncmp(commandStr, "capture start ", 14) == 0)
+	{
+		const char* parts[4];
+		u32 partLengths[4];
+		u32 numParts = SplitNtString(&commandStr[14], ' ', &parts[0], &partLengths[0], ArrayCount(parts));
+		if (numParts < 1 || numParts > 2 || partLengths[0] == 0) { WriteLine_E("Usage: capture start [name] {edges}"); return; }
+		CaptureChannel_t channel = Capture_NumChannels;
+		if (!CaptureFindByName(parts[0], partLengths[0], &channel)) { PrintLine_E("No input capture channel named \"%.*s\"", partLengths[0], parts[0]); return; }
+		i32 numEdgesI32 = 0;
+		if (numParts >= 2 && (!TryParseInt32(parts[1], partLengths[1], &numEdgesI32) || numEdgesI32 < 0 || numEdgesI32 > CAPTURE_BUFFER_SIZE))
+		{
+			PrintLine_E("Invalid edge count given \"%.*s\". Must be 0-%u", partLengths[1], parts[1], CAPTURE_BUFFER_SIZE);
+			return;
+		}
+		if (CaptureStart(channel, (u32)numEdgesI32)) { WriteLine_I("Capture started"); }
+	}
+	
+	// +==============================+
+	// |     capture hist [type]      |
+	// +==============================+
+	else if (commandLength >= 13 && strncmp(commandStr, "capture hist ", 13) == 0)
+	{
+		const char* typeStr = &commandStr[13];
+		if      (strcmp(typeStr, "period") == 0) { CapturePrintHistogram(CaptureMeasure_Period); }
+		else if (strcmp(typeStr, "high")   == 0) { CapturePrintHistogram(CaptureMeasure_High); }
+		else if (strcmp(typeStr, "low")    == 0) { CapturePrintHistogram(CaptureMeasure_Low); }
+		else { PrintLine_E("Unknown histogram type \"%s\". Must be period, high or low", typeStr); }
+	}
+	
+	// +==============================+
+	// |         capture stop         |
+	// +==============================+
+	else if (strcmp(commandStr, "capture stop") == 0)
+	{
+		CaptureStop();
+		WriteLine_I("Capture stopped");
+	}
+	
+	// +==============================+
+	// |             wave             |
+	// +==============================+
+	else if (strcmp(commandStr, "wave") == 0)
+	{
+		WaveformPrintSteps();
+	}
+	
+	// +==============================+
+	// | wave add [mask] [value] [us] |
+	// +==============================+
+	else if (commandLength >= 9 && strncmp(commandStr, "wave add ", 9) == 0)
+	{
+		const char* parts[4];
+		u32 partLengths[4];
+		u32 numParts = SplitNtString(&commandStr[9], ' ', &parts[0], &partLengths[0], ArrayCount(parts));
+		if (numParts != 3) { WriteLine_E("Usage: wave add [mask] [value] [delayUs]"); return; }
+		u32 pinMask = 0;
+		if (!TryParseAddress(parts[0], partLengths[0], &pinMask) || pinMask > 0xFF) { PrintLine_E("Invalid mask given \"%.*s\"", partLengths[0], parts[0]); return; }
+		u32 pinValue = 0;
+		if (!TryParseAddress(parts[1], partLengths[1], &pinValue) || pinValue > 0xFF) { PrintLine_E("Invalid value given \"%.*s\"", partLengths[1], parts[1]); return; }
+		i32 delayUs = 0;
+		if (!TryParseInt32(parts[2], partLengths[2], &delayUs) || delayUs <= 0) { PrintLine_E("Invalid delay given \"%.*s\"", partLengths[2], parts[2]); return; }
+		
+		WaveformAddStep((u8)pinMask, (u8)pinValue, (u32)delayUs);
+	}
+	
+	// +==============================+
+	// |       wave play {loops}      |
+	// +==============================+
+	else if (strcmp(commandStr, "wave play") == 0 || strncmp(commandStr, "wave play ", 10) == 0)
+	{
+		i32 numLoops = 1;
+		if (commandLength > 10 && (!TryParseInt32(&commandStr[10], commandLength - 10, &numLoops) || numLoops < 0))
+		{
+			PrintLine_E("Invalid number of loops \"%s\"", &commandStr[10]);
+			return;
+		}
+		
+		if (WaveformPlay((u32)numLoops))
+		{
+			if (numLoops == 0) { WriteLine_I("Playing waveform until \"wave stop\""); }
+			else { PrintLine_I("Playing waveform %d time%s", numLoops, (numLoops == 1) ? "" : "s"); }
+		}
+	}
+	
+	// +==============================+
+	// |          wave stop           |
+	// +==============================+
+	else if (strcmp(commandStr, "wave stop") == 0)
+	{
+		WaveformStop();
+		WriteLine_I("Waveform stopped");
+	}
+	
+	// +==============================+
+	// |          wave clear          |
+	// +==============================+
+	else if (strcmp(commandStr, "wave clear") == 0)
+	{
+		WaveformClear();
+		WriteLine_I("Waveform cleared");
+	}
+	
+	// +==============================+
+	// |            logic             |
+	// +==============================+
+	else if (strcmp(commandStr, "logic") == 0)
+	{
+		LogicPrintStatus();
+	}
+	
+	// +==============================+
+	// |  logic start [port] [mask]   |
+	// +==============================+
+	else if (commandLength >= 12 && strncmp(commandStr, "logic start ", 12) == 0)
+	{
+		const char* parts[5];
+		u32 partLengths[5];
+		u32 numParts = SplitNtString(&commandStr[12], ' ', &parts[0], &partLengths[0], ArrayCount(parts));
+		if (numParts < 3 || numParts > 4) { WriteLine_E("Usage: logic start [port] [mask] [rateHz] {samples}"); return; }
+		if (partLengths[0] != 1) { PrintLine_E("Invalid port given \"%.*s\"", partLengths[0], parts[0]); return; }
+		u32 mask = 0;
+		if (!TryParseAddress(parts[1], partLengths[1], &mask) || mask == 0 || mask > 0xFFFF) { PrintLine_E("Invalid mask given \"%.*s\"", partLengths[1], parts[1]); return; }
+		i32 rateHz = 0;
+		if (!TryParseInt32(parts[2], partLengths[2], &rateHz) || rateHz <= 0) { PrintLine_E("Invalid rate given \"%.*s\"", partLengths[2], parts[2]); return; }
+		i32 numSamples = 0;
+		if (numParts >= 4 && (!TryParseInt32(parts[3], partLengths[3], &numSamples) || numSamples < 0)) { PrintLine_E("Invalid number of samples given \"%.*s\"", partLengths[3], parts[3]); return; }
+		
+		if (LogicStart(parts[0][0], (u16)mask, (u32)rateHz, (u32)numSamples)) { LogicPrintStatus(); }
+	}
+	
+	// +==============================+
+	// |    logic trig [type] ...     |
+	// +==============================+
+	else if (commandLength >= 11 && strncmp(commandStr, "logic trig ", 11) == 0)
+	{
+		const char* parts[4];
+		u32 partLengths[4];
+		u32 numParts = SplitNtString(&commandStr[11], ' ', &parts[0], &partLengths[0], ArrayCount(parts));
+		u32 mask = 0;
+		u32 value = 0;
+		if (numParts >= 2 && (!TryParseAddress(parts[1], partLengths[1], &mask) || mask > 0xFFFF)) { PrintLine_E("Invalid mask given \"%.*s\"", partLengths[1], parts[1]); return; }
+		if (numParts >= 3 && (!TryParseAddress(parts[2], partLengths[2], &value) || value > 0xFFFF)) { PrintLine_E("Invalid value given \"%.*s\"", partLengths[2], parts[2]); return; }
+		
+		if (numParts == 1 && partLengths[0] == 4 && strncmp(parts[0], "none", 4) == 0) { LogicSetTrigger(LogicTrigger_None, 0, 0); }
+		else if (numParts == 2 && partLengths[0] == 4 && strncmp(parts[0], "edge", 4) == 0) { LogicSetTrigger(LogicTrigger_Edge, (u16)mask, 0); }
+		else if (numParts == 3 && partLengths[0] == 7 && strncmp(parts[0], "pattern", 7) == 0) { LogicSetTrigger(LogicTrigger_Pattern, (u16)mask, (u16)value); }
+		else { WriteLine_E("Usage: logic trig none, logic trig edge [mask] or logic trig pattern [mask] [value]"); return; }
+		WriteLine_I("Trigger set for the next capture");
+	}
+	
+	// +==============================+
+	// |          logic stop          |
+	// +==============================+
+	else if (strcmp(commandStr, "logic stop") == 0)
+	{
+		LogicStop();
+		LogicPrintStatus();
+	}
+	
+	// +==============================+
+	// |          logic vcd           |
+	// +==============================+
+	else if (strcmp(commandStr, "logic vcd") == 0)
+	{
+		LogicStartVcdUpload();
+	}
+	
+	// +==============================+
+	// |            bench             |
+	// +==============================+
+	else if (strcmp(commandStr, "bench") == 0)
+	{
+		BenchPrintReport();
 	}
+	else if (strcmp(commandStr, "bench toggle") == 0) { BenchToggle(); }
+	else if (strcmp(commandStr, "bench isr") == 0)    { BenchIsr();    }
+	else if (strcmp(commandStr, "bench dma") == 0)    { BenchDma();    }
+	else if (strcmp(commandStr, "bench memcpy") == 0) { BenchMemcpy(); }
 	
 	// +==============================+
 	// |       Unknown Command        |
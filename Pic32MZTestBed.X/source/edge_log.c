@@ -0,0 +1,178 @@
+/*
+File:   edge_log.c
+Author: Taylor Robbins
+Date:   10\19\2026
+Description:
+	** Keeps a binary log of every raw edge on the inputs in INPUT_PINS (bounces included) so their timing can be looked
+	** at later. The change notification ISR stamps each edge with TimeNowCycles and drops a small fixed size entry into
+	** a ring, which is all the work done at interrupt time. Nothing is formatted or printed until someone asks.
+	
+	** EdgeLogPrint turns entries into text in batches, and only when DebugFifoTx has room for the whole batch, so a busy
+	** UART makes the log fall behind instead of delaying the ISR or changing the timestamps. The "edgelog stream" job
+	** calls it from the main loop to keep emptying the ring while the test runs.
+	** When the ring is full new edges are dropped and counted. Their sequence numbers still get used up so the gap is
+	** visible in the printed log
+*/
+
+#include "app.h"
+#include "edge_log.h"
+
+#include "micro.h"
+#include "debug.h"
+#include "tick_timer.h"
+#include "inputs.h"
+#include "jobs.h"
+
+// +--------------------------------------------------------------+
+// |                     Private Definitions                      |
+// +--------------------------------------------------------------+
+#define EDGE_LOG_DELTA_STR_SIZE 24
+
+#if ((EDGE_LOG_SIZE & (EDGE_LOG_SIZE-1)) != 0)
+#error EDGE_LOG_SIZE must be a power of 2
+#endif
+
+// +--------------------------------------------------------------+
+// |                        Public Globals                        |
+// +--------------------------------------------------------------+
+volatile u32 EdgeLogOverflowCount = 0;
+
+// +--------------------------------------------------------------+
+// |                       Private Globals                        |
+// +--------------------------------------------------------------+
+static EdgeLogEntry_t Entries[EDGE_LOG_SIZE];
+static volatile u32 entriesHead = 0; //written by the ISR
+static volatile u32 entriesTail = 0; //written by EdgeLogPrint
+static volatile u32 nextSequence = 0;
+
+static u32 lastPrintedSequence = 0;
+static bool anyPrinted = false;
+static u64 lastEdgeCycles[Input_NumInputs]; //for the time since the last edge on the same input
+static bool lastEdgeValid[Input_NumInputs];
+
+static bool streaming = false;
+static u32 streamJobId = 0;
+
+// +--------------------------------------------------------------+
+// |                      Private Functions                       |
+// +--------------------------------------------------------------+
+static void EdgeLogPrintEntry(const EdgeLogEntry_t* entry)
+{
+	if (anyPrinted && entry->sequence - lastPrintedSequence > 1)
+	{
+		PrintLine_W("  (%u edges dropped)", entry->sequence - lastPrintedSequence - 1);
+	}
+	
+	//Time since the last edge on the same input, which is what shows the bounces
+	Input_t input = (Input_t)entry->input;
+	char deltaStr[EDGE_LOG_DELTA_STR_SIZE];
+	deltaStr[0] = '\0';
+	if (input < Input_NumInputs && lastEdgeValid[input])
+	{
+		u64 deltaCycles = entry->timeCycles - lastEdgeCycles[input];
+		if (deltaCycles >= TIME_CYCLES_PER_US * 1000000ULL) { snprintf(deltaStr, sizeof(deltaStr), " (+%ums)", (u32)(deltaCycles / (TIME_CYCLES_PER_US * 1000))); }
+		else { snprintf(deltaStr, sizeof(deltaStr), " (+%u.%02uus)", (u32)deltaCycles / TIME_CYCLES_PER_US, (((u32)deltaCycles % TIME_CYCLES_PER_US) * 100) / TIME_CYCLES_PER_US); }
+	}
+	if (input < Input_NumInputs)
+	{
+		lastEdgeCycles[input] = entry->timeCycles;
+		lastEdgeValid[input] = true;
+	}
+	
+	u64 timeUs = entry->timeCycles / TIME_CYCLES_PER_US;
+	PrintLine_I("#%-5u %u.%06us %-8s %-4s PORT 0x%04X%s", entry->sequence, (u32)(timeUs / 1000000), (u32)(timeUs % 1000000),
+		GetInputName(input), entry->isDown ? "Down" : "Up", entry->portValue, deltaStr
+	);
+	lastPrintedSequence = entry->sequence;
+	anyPrinted = true;
+}
+
+static JobResult_t EdgeLogStreamJob(Job_t* job)
+{
+	if (job->killRequested) { streaming = false; return JobResult_Done; }
+	//Wait until the whole batch fits rather than dribbling out one line at a time
+	if (EdgeLogNumPending() > 0 && DebugUartTxSpace() >= EDGE_LOG_BATCH_SIZE * EDGE_LOG_LINE_SIZE) { EdgeLogPrint(EDGE_LOG_BATCH_SIZE); }
+	return JobResult_InProgress;
+}
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void EdgeLogInit()
+{
+	ClearArray(Entries);
+	ClearArray(lastEdgeCycles);
+	ClearArray(lastEdgeValid);
+	entriesHead = 0;
+	entriesTail = 0;
+	nextSequence = 0;
+	anyPrinted = false;
+	streaming = false;
+}
+
+//NOTE: Called from InputsChangeIsr. Keep this short
+void EdgeLogRecord(u8 input, bool isDown, u16 portValue, u64 timeCycles)
+{
+	u32 sequence = nextSequence;
+	nextSequence = sequence + 1;
+	if (entriesHead - entriesTail >= EDGE_LOG_SIZE) { EdgeLogOverflowCount++; return; }
+	EdgeLogEntry_t* entry = &Entries[entriesHead % EDGE_LOG_SIZE];
+	entry->timeCycles = timeCycles;
+	entry->sequence = sequence;
+	entry->portValue = portValue;
+	entry->input = input;
+	entry->isDown = isDown ? 1 : 0;
+	entriesHead++;
+}
+
+u32 EdgeLogNumPending()
+{
+	return entriesHead - entriesTail;
+}
+
+//Prints up to maxEntries (0 for as many as there are), but only as many as DebugFifoTx has room for. Returns how many were printed
+u32 EdgeLogPrint(u32 maxEntries)
+{
+	//While a raw transfer has the UART our lines would just pile up in the held output, so leave them in the ring
+	if (DebugUartOutputHeld()) { return 0; }
+	u32 numPending = EdgeLogNumPending();
+	if (maxEntries == 0 || maxEntries > numPending) { maxEntries = numPending; }
+	if (maxEntries > DebugUartTxSpace() / EDGE_LOG_LINE_SIZE) { maxEntries = DebugUartTxSpace() / EDGE_LOG_LINE_SIZE; }
+	u32 numPrinted = 0;
+	while (numPrinted < maxEntries)
+	{
+		EdgeLogPrintEntry(&Entries[entriesTail % EDGE_LOG_SIZE]);
+		entriesTail++;
+		numPrinted++;
+	}
+	return numPrinted;
+}
+
+void EdgeLogClear()
+{
+	entriesTail = entriesHead;
+	EdgeLogOverflowCount = 0;
+	ClearArray(lastEdgeValid);
+	anyPrinted = false;
+}
+
+bool EdgeLogStartStream()
+{
+	if (streaming) { WriteLine_E("The edge log is already streaming"); return false; }
+	Job_t* job = JobStart("edgelog", EdgeLogStreamJob);
+	if (job == nullptr) { return false; }
+	streamJobId = job->id;
+	streaming = true;
+	return true;
+}
+
+void EdgeLogStopStream()
+{
+	if (!streaming) { return; }
+	JobKill(streamJobId);
+}
+
+bool EdgeLogIsStreaming()
+{
+	return streaming;
+}
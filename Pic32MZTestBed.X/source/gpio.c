@@ -0,0 +1,111 @@
+/*
+File:   gpio.c
+Author: Taylor Robbins
+Date:   10\19\2026
+Description:
+	** Holds the named output pins from the GPIO_OUTPUTS table and functions to drive them
+	** Writing a single bit of LATx (ex. LATHbits.LATH0 = 1) compiles to a read-modify-write of the whole register, which
+	** can undo a change that an ISR made to another pin on the same port in between, and it can only change one pin at a time.
+	** Every function here instead does a single store to the LATxSET, LATxCLR or LATxINV register so only the bits in the
+	** mask change and several pins on one port can change in the same cycle.
+*/
+
+#include "app.h"
+#include "gpio.h"
+
+#include "debug.h"
+
+// +--------------------------------------------------------------+
+// |                     Private Definitions                      |
+// +--------------------------------------------------------------+
+#define GPIO_PORT_ENTRY(port) { "PORT" #port, &LAT##port, &LAT##port##CLR, &LAT##port##SET, &LAT##port##INV, &PORT##port },
+#define GPIO_PIN_ENTRY(name, port, bit) { #name, GpioPort_##port, (bit), (1 << (bit)) },
+
+// +--------------------------------------------------------------+
+// |                        Public Globals                        |
+// +--------------------------------------------------------------+
+const GpioPortRegs_t GpioPorts[GpioPort_NumPorts] = { GPIO_PORTS(GPIO_PORT_ENTRY) };
+const GpioPin_t GpioPins[Gpio_NumPins] = { GPIO_OUTPUTS(GPIO_PIN_ENTRY) };
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void GpioSet(Gpio_t pin)
+{
+	Assert(pin < Gpio_NumPins);
+	*GpioPorts[GpioPins[pin].port].latSetReg = GpioPins[pin].mask;
+}
+
+void GpioClear(Gpio_t pin)
+{
+	Assert(pin < Gpio_NumPins);
+	*GpioPorts[GpioPins[pin].port].latClrReg = GpioPins[pin].mask;
+}
+
+void GpioToggle(Gpio_t pin)
+{
+	Assert(pin < Gpio_NumPins);
+	*GpioPorts[GpioPins[pin].port].latInvReg = GpioPins[pin].mask;
+}
+
+void GpioWrite(Gpio_t pin, bool high)
+{
+	if (high) { GpioSet(pin); }
+	else { GpioClear(pin); }
+}
+
+//Returns the value we are driving the pin to (the latch), not the level measured on the pin
+bool GpioRead(Gpio_t pin)
+{
+	Assert(pin < Gpio_NumPins);
+	return ((*GpioPorts[GpioPins[pin].port].latReg & GpioPins[pin].mask) != 0);
+}
+
+void GpioPortSet(GpioPort_t port, u32 mask)
+{
+	Assert(port < GpioPort_NumPorts);
+	*GpioPorts[port].latSetReg = mask;
+}
+
+void GpioPortClear(GpioPort_t port, u32 mask)
+{
+	Assert(port < GpioPort_NumPorts);
+	*GpioPorts[port].latClrReg = mask;
+}
+
+void GpioPortToggle(GpioPort_t port, u32 mask)
+{
+	Assert(port < GpioPort_NumPorts);
+	*GpioPorts[port].latInvReg = mask;
+}
+
+//Drives every pin in mask to the matching bit of value with one store to LATxINV, so they all change on the same cycle
+//NOTE: Pins outside the mask are never touched. Only an ISR that writes a pin inside the mask between our read of LATx
+//      and the store can get its change overwritten
+void GpioPortWrite(GpioPort_t port, u32 mask, u32 value)
+{
+	Assert(port < GpioPort_NumPorts);
+	const GpioPortRegs_t* regs = &GpioPorts[port];
+	*regs->latInvReg = ((*regs->latReg ^ value) & mask);
+}
+
+const char* GetGpioName(Gpio_t pin)
+{
+	if (pin >= Gpio_NumPins) { return "Unknown"; }
+	return GpioPins[pin].name;
+}
+
+bool GpioFindByName(const char* name, u32 nameLength, Gpio_t* pinOut)
+{
+	u32 pIndex;
+	for (pIndex = 0; pIndex < Gpio_NumPins; pIndex++)
+	{
+		const char* pinName = GpioPins[pIndex].name;
+		if (strlen(pinName) == nameLength && strncmp(pinName, name, nameLength) == 0)
+		{
+			if (pinOut != nullptr) { *pinOut = (Gpio_t)pIndex; }
+			return true;
+		}
+	}
+	return false;
+}
@@ -447,3 +447,36 @@ const char* GetFileNamePart(const char* filePath)
 	return result;
 }
 
+//Same as TryParseHex32 but allows an optional 0x prefix
+bool TryParseAddress(const char* str, u32 numChars, u32* outValue)
+{
+	if (str == nullptr) { return false; }
+	if (numChars >= 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X'))
+	{
+		str += 2;
+		numChars -= 2;
+	}
+	return TryParseHex32(str, numChars, outValue);
+}
+
+//Standard CRC-32 (same as zlib/Ethernet) using a 16 entry table. Pass 0 as previousCrc for the first block
+u32 CalculateCrc32(u32 previousCrc, const u8* dataPntr, u32 dataLength)
+{
+	static const u32 crcTable[16] =
+	{
+		0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+		0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+	};
+	Assert(dataPntr != nullptr || dataLength == 0);
+	
+	u32 crc = ~previousCrc;
+	u32 bIndex;
+	for (bIndex = 0; bIndex < dataLength; bIndex++)
+	{
+		crc ^= dataPntr[bIndex];
+		crc = (crc >> 4) ^ crcTable[crc & 0x0F];
+		crc = (crc >> 4) ^ crcTable[crc & 0x0F];
+	}
+	return ~crc;
+}
+
@@ -17,6 +17,7 @@ Description:
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
@@ -42,17 +43,31 @@ Description:
 
 #define DEBUG_WINDOWS_LINE_ENDINGS  false
 #define DEBUG_OUTPUT_LEVEL_PREFIX   true
-#define DEBUG_ECHO_INPUT_CHARACTERS true
+#define DEBUG_ECHO_INPUT_CHARACTERS true //Default value, can be changed at runtime with DebugUartSetEcho
 #define DEBUG_OUTPUT_FILE_NAMES     false
 
 #define DEBUG_OUTPUT_FIFO_LENGTH     2048 //chars
+#define DEBUG_HELD_FIFO_LENGTH       512 //chars of text output kept back while a raw transfer (VCD, binary dump) has the UART
 #define DEBUG_INPUT_FIFO_LENGTH      128 //chars
+#define DEBUG_INPUT_RAW_FIFO_LENGTH  256 //bytes, filled by the Rx ISR and drained by DebugUartUpdate
+#define DEBUG_INPUT_BATCH_SIZE       32 //bytes, max echo produced per call to DebugUartTxPutBytes
 #define DEBUG_INPUT_MAX_LENGTH       64 //chars
 #define DEBUG_PRINT_BUFFER_SIZE      512 //chars
 #define DEBUG_OVERFLOW_BACKOFF       1000 //ms
 
+#define DEBUG_RX_COALESCE_ENABLED    true //Only interrupt when the Rx hardware FIFO is half full (or has been idle for DEBUG_RX_IDLE_TIMEOUT)
+#define DEBUG_RX_IDLE_TIMEOUT        2 //ms
+#define DEBUG_RX_DMA_ENABLED         false //Receive into ping-pong buffers using DMA channel 0 instead of the Rx interrupt
+#define DEBUG_RX_DMA_BUFFER_SIZE     256 //bytes (x2)
+
 #define BUTTON_DEBOUNCE_TIME         50 //ms
 
+#define TICK_TIMER_TICKLESS_ENABLED  false //Start up in tickless mode. Can be changed at runtime with the "tickless" command
+
+#define ISR_STATS_ENABLED            true //Record interrupt latency histograms (see the "isrstat" command)
+
+#define SCHEDULER_IDLE_WAIT_ENABLED  true //Put the core to sleep with WAIT when the main loop has nothing to do
+
 // +--------------------------------------------------------------+
 // |                   Public Structures/Types                    |
 // +--------------------------------------------------------------+
@@ -0,0 +1,29 @@
+/*
+File:   bench.h
+Author: Taylor Robbins
+Date:   10\19\2026
+*/
+
+#ifndef _BENCH_H
+#define _BENCH_H
+
+// +--------------------------------------------------------------+
+// |                      Public Definitions                      |
+// +--------------------------------------------------------------+
+#define BENCH_NUM_TOGGLES      1000 //must be even so the pin ends up where it started
+#define BENCH_NUM_ISR_SAMPLES  100
+#define BENCH_DMA_NUM_WRITES   256
+#define BENCH_MEMCPY_SIZE      4096 //bytes
+#define BENCH_MEMCPY_REPEATS   64
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void BenchInit();
+void BenchToggle();
+void BenchIsr();
+void BenchDma();
+void BenchMemcpy();
+void BenchPrintReport();
+
+#endif //  _BENCH_H
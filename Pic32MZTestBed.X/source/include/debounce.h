@@ -0,0 +1,42 @@
+/*
+File:   debounce.h
+Author: Taylor Robbins
+Date:   10\19\2026
+*/
+
+#ifndef _DEBOUNCE_H
+#define _DEBOUNCE_H
+
+// +--------------------------------------------------------------+
+// |                      Public Definitions                      |
+// +--------------------------------------------------------------+
+//NOTE: A bit has to read the same for 4 samples in a row before its debounced state changes
+#define DEBOUNCE_SAMPLE_PERIOD 10 //ms, so inputs settle after 30-40ms
+#define DEBOUNCE_SAMPLE_DEADLINE 2 //ms after each release that the sample has to be taken by
+
+//NOTE: Add a line here to debounce another port. Only the bits in the mask are reported
+//                     Port Mask
+#define DEBOUNCE_PORTS(PORT) \
+	PORT(B,   0x7000) /*TEST_BTN1-3*/
+
+// +--------------------------------------------------------------+
+// |                   Public Structures/Types                    |
+// +--------------------------------------------------------------+
+#define DEBOUNCE_ENUM_ENTRY(port, mask) DebouncePort_##port,
+typedef enum
+{
+	DEBOUNCE_PORTS(DEBOUNCE_ENUM_ENTRY)
+	DebouncePort_NumPorts,
+} DebouncePort_t;
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void DebounceInit();
+void DebounceSample();
+u16  DebounceGetState(DebouncePort_t port);
+u16  DebounceTakeRisingEdges(DebouncePort_t port);
+u16  DebounceTakeFallingEdges(DebouncePort_t port);
+void DebouncePrintPorts();
+
+#endif //  _DEBOUNCE_H
@@ -7,6 +7,15 @@ Date:   08\29\2019
 #ifndef _DEBUG_H
 #define _DEBUG_H
 
+// +--------------------------------------------------------------+
+// |                        Public Globals                        |
+// +--------------------------------------------------------------+
+extern volatile u32 DebugUartRxIsrCount;
+extern volatile u32 DebugUartRxByteCount;
+extern volatile u32 DebugUartRxIdleFlushCount;
+extern volatile u32 DebugUartRxErrorCount;
+extern volatile u32 DebugUartRxOverflowCount;
+
 // +--------------------------------------------------------------+
 // |                       Public Functions                       |
 // +--------------------------------------------------------------+
@@ -17,10 +26,20 @@ void  DebugPutByte(u8 newByte);
 void  DebugUartWrite(const char* rawFileName, OutputLevel_t outputLevel, bool newLine, const char* string);
 void  DebugUartPrint(const char* rawFileName, OutputLevel_t outputLevel, bool newLine, const char* formatStr, ...);
 void  DebugUartFlush();
+bool  DebugUartTxIdle();
+u32   DebugUartTxSpace();
+bool  DebugUartHoldOutput();
+void  DebugUartReleaseOutput();
+bool  DebugUartOutputHeld();
+u32   DebugUartSetBaudRate(u32 baudRate);
+u32   DebugUartGetBaudRate();
 char* DebugUartReadLine();
 u32   DebugUartRxLength();
 char  DebugUartRxGet(u32 offset);
 void  DebugUartUpdate();
+bool  DebugUartRxIdleTick(u32 elapsedMs);
+void  DebugUartSetEcho(bool enabled);
+bool  DebugUartGetEcho();
 
 // +--------------------------------------------------------------+
 // |                        Public Macros                         |
@@ -0,0 +1,46 @@
+/*
+File:   edge_log.h
+Author: Taylor Robbins
+Date:   10\19\2026
+*/
+
+#ifndef _EDGE_LOG_H
+#define _EDGE_LOG_H
+
+// +--------------------------------------------------------------+
+// |                      Public Definitions                      |
+// +--------------------------------------------------------------+
+#define EDGE_LOG_SIZE       256 //entries (16 bytes each), must be a power of 2
+#define EDGE_LOG_BATCH_SIZE 16  //entries printed at a time, only once the UART has room for the whole batch
+#define EDGE_LOG_LINE_SIZE  80  //chars we leave room for in DebugFifoTx per entry
+
+// +--------------------------------------------------------------+
+// |                   Public Structures/Types                    |
+// +--------------------------------------------------------------+
+typedef struct
+{
+	u64 timeCycles; //TimeNowCycles() when the change notification ISR ran
+	u32 sequence;   //counts every edge, including ones that were dropped, so gaps show up when the log is printed
+	u16 portValue;  //the whole port as the ISR read it
+	u8 input;       //Input_t
+	u8 isDown;
+} EdgeLogEntry_t;
+
+// +--------------------------------------------------------------+
+// |                        Public Globals                        |
+// +--------------------------------------------------------------+
+extern volatile u32 EdgeLogOverflowCount;
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void EdgeLogInit();
+void EdgeLogRecord(u8 input, bool isDown, u16 portValue, u64 timeCycles);
+u32  EdgeLogNumPending();
+u32  EdgeLogPrint(u32 maxEntries);
+void EdgeLogClear();
+bool EdgeLogStartStream();
+void EdgeLogStopStream();
+bool EdgeLogIsStreaming();
+
+#endif //  _EDGE_LOG_H
@@ -0,0 +1,92 @@
+/*
+File:   gpio.h
+Author: Taylor Robbins
+Date:   10\19\2026
+*/
+
+#ifndef _GPIO_H
+#define _GPIO_H
+
+// +--------------------------------------------------------------+
+// |                      Public Definitions                      |
+// +--------------------------------------------------------------+
+#define GPIO_PORTS(PORT) \
+	PORT(A) PORT(B) PORT(C) PORT(D) PORT(E) PORT(F) PORT(G) PORT(H) PORT(J) PORT(K)
+
+//NOTE: Add a line here to give an output pin a name. The pin still needs to be made an output (TRISx in MicroInit)
+//      TestPin1-6 need to stay in order since the "pin" command indexes them by number
+//                  Name      Port Bit
+#define GPIO_OUTPUTS(OUTPUT)      \
+	OUTPUT(TestLed1, H,   0) /*Red*/    \
+	OUTPUT(TestLed2, H,   1) /*Yellow*/ \
+	OUTPUT(TestLed3, H,   2) /*Green*/  \
+	OUTPUT(TestPin1, K,   1) \
+	OUTPUT(TestPin2, K,   2) \
+	OUTPUT(TestPin3, K,   3) \
+	OUTPUT(TestPin4, K,   4) \
+	OUTPUT(TestPin5, K,   5) \
+	OUTPUT(TestPin6, K,   6)
+
+// +--------------------------------------------------------------+
+// |                   Public Structures/Types                    |
+// +--------------------------------------------------------------+
+#define GPIO_PORT_ENUM_ENTRY(port) GpioPort_##port,
+typedef enum
+{
+	GPIO_PORTS(GPIO_PORT_ENUM_ENTRY)
+	GpioPort_NumPorts,
+} GpioPort_t;
+
+#define GPIO_ENUM_ENTRY(name, port, bit) Gpio_##name,
+typedef enum
+{
+	GPIO_OUTPUTS(GPIO_ENUM_ENTRY)
+	Gpio_NumPins,
+} Gpio_t;
+
+//These let us name pins in port-wide writes, ex: GpioPortWrite(GpioPortOf(TestPin1), GpioMask(TestPin1)|GpioMask(TestPin2), 0)
+#define GPIO_MASK_ENUM_ENTRY(name, port, bit) GpioMask_##name = (1 << (bit)), GpioPortOf_##name = GpioPort_##port,
+enum { GPIO_OUTPUTS(GPIO_MASK_ENUM_ENTRY) };
+#define GpioMask(name)   GpioMask_##name
+#define GpioPortOf(name) ((GpioPort_t)GpioPortOf_##name)
+
+typedef struct
+{
+	const char* name;
+	volatile unsigned int* latReg;
+	volatile unsigned int* latClrReg;
+	volatile unsigned int* latSetReg;
+	volatile unsigned int* latInvReg;
+	volatile unsigned int* portReg;
+} GpioPortRegs_t;
+
+typedef struct
+{
+	const char* name;
+	GpioPort_t port;
+	u8 bit;
+	u32 mask;
+} GpioPin_t;
+
+// +--------------------------------------------------------------+
+// |                        Public Globals                        |
+// +--------------------------------------------------------------+
+extern const GpioPortRegs_t GpioPorts[GpioPort_NumPorts];
+extern const GpioPin_t GpioPins[Gpio_NumPins];
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void GpioSet(Gpio_t pin);
+void GpioClear(Gpio_t pin);
+void GpioToggle(Gpio_t pin);
+void GpioWrite(Gpio_t pin, bool high);
+bool GpioRead(Gpio_t pin);
+void GpioPortSet(GpioPort_t port, u32 mask);
+void GpioPortClear(GpioPort_t port, u32 mask);
+void GpioPortToggle(GpioPort_t port, u32 mask);
+void GpioPortWrite(GpioPort_t port, u32 mask, u32 value);
+const char* GetGpioName(Gpio_t pin);
+bool GpioFindByName(const char* name, u32 nameLength, Gpio_t* pinOut);
+
+#endif //  _GPIO_H
@@ -23,5 +23,7 @@ bool TryParseHexBytes(const char* str, u32 numCharacters, u8* bufferOut, u32 buf
 u32 SplitString(const char* str, u32 strLength, char splitChar, const char** partsBuffer, u32* lengthsBuffer, u32 maxParts);
 u32 SplitNtString(const char* nullTermString, char splitChar, const char** partsBuffer, u32* lengthsBuffer, u32 maxParts);
 const char* GetFileNamePart(const char* filePath);
+bool TryParseAddress(const char* str, u32 numChars, u32* outValue);
+u32 CalculateCrc32(u32 previousCrc, const u8* dataPntr, u32 dataLength);
 
 #endif //  _HELPERS_H
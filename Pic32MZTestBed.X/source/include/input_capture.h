@@ -0,0 +1,53 @@
+/*
+File:   input_capture.h
+Author: Taylor Robbins
+Date:   10\19\2026
+*/
+
+#ifndef _INPUT_CAPTURE_H
+#define _INPUT_CAPTURE_H
+
+// +--------------------------------------------------------------+
+// |                      Public Definitions                      |
+// +--------------------------------------------------------------+
+#define CAPTURE_BUFFER_SIZE     2048 //edges (4 bytes each)
+#define CAPTURE_HISTOGRAM_BINS  16
+#define CAPTURE_HISTOGRAM_WIDTH 40   //chars in the longest bar
+
+//NOTE: Add a line here (and the matching ICxR mapping in MicroInit) to measure another header pin
+//               name, module, pin, header pin
+#define CAPTURE_CHANNELS(CHANNEL) \
+	CHANNEL(Ic1, 1, "RD1",  23) \
+	CHANNEL(Ic2, 2, "RG6",  8)  \
+	CHANNEL(Ic3, 3, "RA14", 7)  \
+	CHANNEL(Ic6, 6, "RB14", 10) //also TEST_BTN3 (SW3)
+
+// +--------------------------------------------------------------+
+// |                   Public Structures/Types                    |
+// +--------------------------------------------------------------+
+#define CAPTURE_ENUM_ENTRY(name, module, pinName, headerPin) Capture_##name,
+typedef enum
+{
+	CAPTURE_CHANNELS(CAPTURE_ENUM_ENTRY)
+	Capture_NumChannels,
+} CaptureChannel_t;
+
+typedef enum
+{
+	CaptureMeasure_Period = 0x00, //rising edge to rising edge
+	CaptureMeasure_High   = 0x01, //rising edge to falling edge
+	CaptureMeasure_Low    = 0x02, //falling edge to rising edge
+} CaptureMeasure_t;
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void CaptureInit();
+bool CaptureStart(CaptureChannel_t channel, u32 maxEdges); //0 fills the whole buffer
+void CaptureStop();
+bool CaptureIsRunning();
+bool CaptureFindByName(const char* name, u32 nameLength, CaptureChannel_t* channelOut);
+void CapturePrintReport();
+void CapturePrintHistogram(CaptureMeasure_t measure);
+
+#endif //  _INPUT_CAPTURE_H
@@ -0,0 +1,63 @@
+/*
+File:   inputs.h
+Author: Taylor Robbins
+Date:   10\19\2026
+*/
+
+#ifndef _INPUTS_H
+#define _INPUTS_H
+
+// +--------------------------------------------------------------+
+// |                      Public Definitions                      |
+// +--------------------------------------------------------------+
+#define INPUT_EDGE_QUEUE_SIZE  32 //raw edges waiting for InputsUpdate, must be a power of 2
+#define INPUT_EVENT_QUEUE_SIZE 16 //debounced events waiting for the application, must be a power of 2
+
+//NOTE: Every input has to be on PORTB since that is the only change notification interrupt we have hooked up.
+//      The pin also needs to be a digital input (ANSELB/TRISB in MicroInit) with its pullup turned on if needed
+//            Name     Bit ActiveLow
+#define INPUT_PINS(INPUT)     \
+	INPUT(Button1, 12, true)  \
+	INPUT(Button2, 13, true)  \
+	INPUT(Button3, 14, true)
+
+// +--------------------------------------------------------------+
+// |                   Public Structures/Types                    |
+// +--------------------------------------------------------------+
+#define INPUT_ENUM_ENTRY(name, bit, activeLow) Input_##name,
+typedef enum
+{
+	INPUT_PINS(INPUT_ENUM_ENTRY)
+	Input_NumInputs,
+} Input_t;
+
+typedef enum
+{
+	InputEventType_Pressed  = 0x00,
+	InputEventType_Released = 0x01,
+} InputEventType_t;
+
+typedef struct
+{
+	Input_t input;
+	InputEventType_t type;
+	u32 timeMs;     //when the first edge of the change was seen by the change notification ISR
+	u32 durationMs; //how long the input was in the previous state (ex. how long a button was held for a Released event)
+} InputEvent_t;
+
+// +--------------------------------------------------------------+
+// |                        Public Globals                        |
+// +--------------------------------------------------------------+
+extern volatile u32 InputsEdgeOverflowCount;
+extern u32 InputsEventOverflowCount;
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void InputsInit();
+void InputsUpdate();
+bool InputsPopEvent(InputEvent_t* eventOut);
+bool InputIsDown(Input_t input);
+const char* GetInputName(Input_t input);
+
+#endif //  _INPUTS_H
@@ -0,0 +1,49 @@
+/*
+File:   isr_stats.h
+Author: Taylor Robbins
+Date:   10\19\2026
+*/
+
+#ifndef _ISR_STATS_H
+#define _ISR_STATS_H
+
+// +--------------------------------------------------------------+
+// |                      Public Definitions                      |
+// +--------------------------------------------------------------+
+#define ISR_STATS_NUM_BUCKETS 16 //Bucket 0 is 0 cycles, bucket N is [2^(N-1), 2^N) cycles, the last bucket holds everything larger
+
+// +--------------------------------------------------------------+
+// |                   Public Structures/Types                    |
+// +--------------------------------------------------------------+
+typedef enum
+{
+	IsrStatId_TickTimer = 0,
+	IsrStatId_DebugRx,
+	IsrStatId_DebugTx,
+	IsrStatId_NumIds,
+} IsrStatId_t;
+
+//NOTE: Latencies are measured in CP0 Count cycles (see TIME_CYCLES_PER_US)
+typedef struct
+{
+	u32 numSamples;
+	u32 minCycles;
+	u32 maxCycles;
+	u32 buckets[ISR_STATS_NUM_BUCKETS];
+} IsrStat_t;
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void IsrStatsReset();
+void IsrStatsPrint();
+
+#if ISR_STATS_ENABLED
+void IsrStatsRecord(IsrStatId_t statId, u32 latencyCycles);
+#define IsrStatsMark(countVariable) (countVariable) = _CP0_GET_COUNT()
+#else
+#define IsrStatsRecord(statId, latencyCycles) //nothing
+#define IsrStatsMark(countVariable)           //nothing
+#endif
+
+#endif //  _ISR_STATS_H
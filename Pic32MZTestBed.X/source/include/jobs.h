@@ -0,0 +1,63 @@
+/*
+File:   jobs.h
+Author: Taylor Robbins
+Date:   10\19\2026
+*/
+
+#ifndef _JOBS_H
+#define _JOBS_H
+
+// +--------------------------------------------------------------+
+// |                      Public Definitions                      |
+// +--------------------------------------------------------------+
+#define MAX_NUM_JOBS      4
+#define JOB_MAX_NUM_ARGS  4
+
+// +--------------------------------------------------------------+
+// |                   Public Structures/Types                    |
+// +--------------------------------------------------------------+
+typedef enum
+{
+	JobResult_Done       = 0x00,
+	JobResult_InProgress = 0x01,
+} JobResult_t;
+
+typedef struct Job_t Job_t;
+typedef JobResult_t (*JobFunc_f)(Job_t* job);
+
+struct Job_t
+{
+	bool active;
+	bool killRequested;
+	u32 id;
+	const char* name;
+	JobFunc_f function;
+	u32 state; //resume point used by the JobBegin/JobYield macros. Starts at 0
+	u32 startTimeMs;
+	u32 numPasses;
+	u32 args[JOB_MAX_NUM_ARGS];
+	void* userPntr;
+};
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void   JobsInit();
+Job_t* JobStart(const char* name, JobFunc_f function);
+bool   JobKill(u32 jobId);
+u32    JobsNumActive();
+void   JobsPrintList();
+void   JobsUpdate();
+
+// +--------------------------------------------------------------+
+// |                        Public Macros                         |
+// +--------------------------------------------------------------+
+//NOTE: These macros let a job function be written top to bottom like a normal function (protothread style).
+//      Local variables are NOT preserved across a yield, anything that needs to survive must be stored in the job.
+//      Only one JobYield/JobWaitUntil may appear per line since the line number is used as the resume point.
+#define JobBegin(job) switch ((job)->state) { case 0:
+#define JobYield(job) do { (job)->state = __LINE__; return JobResult_InProgress; case __LINE__:; } while(0)
+#define JobWaitUntil(job, condition) do { (job)->state = __LINE__; case __LINE__: if (!(condition)) { return JobResult_InProgress; } } while(0)
+#define JobEnd(job) } (job)->state = 0; return JobResult_Done
+
+#endif //  _JOBS_H
@@ -0,0 +1,45 @@
+/*
+File:   logic_analyzer.h
+Author: Taylor Robbins
+Date:   10\19\2026
+*/
+
+#ifndef _LOGIC_ANALYZER_H
+#define _LOGIC_ANALYZER_H
+
+// +--------------------------------------------------------------+
+// |                      Public Definitions                      |
+// +--------------------------------------------------------------+
+#define LOGIC_BUFFER_SIZE   4096 //runs (4 bytes each), must be a power of 2
+#define LOGIC_MAX_RATE_HZ   500000 //the Timer6 ISR can't keep up with anything faster
+#define LOGIC_MIN_RATE_HZ   10
+
+// +--------------------------------------------------------------+
+// |                   Public Structures/Types                    |
+// +--------------------------------------------------------------+
+typedef enum
+{
+	LogicTrigger_None    = 0x00, //start capturing right away
+	LogicTrigger_Pattern = 0x01, //start once (PORTx & triggerMask) == triggerValue
+	LogicTrigger_Edge    = 0x02, //start once any pin in triggerMask changes
+} LogicTrigger_t;
+
+//One run of identical samples. Consecutive samples that read the same only take up one entry
+typedef struct
+{
+	u16 value;
+	u16 numSamples;
+} LogicRun_t;
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void LogicInit();
+void LogicSetTrigger(LogicTrigger_t type, u16 mask, u16 value);
+bool LogicStart(char portLetter, u16 mask, u32 rateHz, u32 maxSamples);
+void LogicStop();
+bool LogicIsRunning();
+void LogicPrintStatus();
+bool LogicStartVcdUpload();
+
+#endif //  _LOGIC_ANALYZER_H
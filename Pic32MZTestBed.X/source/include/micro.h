@@ -14,6 +14,17 @@ Date:   08\29\2019
 #define MICRO_PERF_BUS2_FREQ    (MICRO_SYS_CLK_FREQ / 2) //PB2DIV is set to 2x by default
 #define MICRO_PERF_BUS3_FREQ    (MICRO_SYS_CLK_FREQ / 2) //PB3DIV is set to 2x by default
 #define MICRO_ONE_MS_COUNT      ((MICRO_SYS_CLK_FREQ/2)/1000)
+#define MICRO_ONE_US_COUNT      ((MICRO_SYS_CLK_FREQ/2)/1000000)
+
+//Physical memory map of the PIC32MZ2048EFH144 (see the Memory Organization section of the datasheet)
+#define MICRO_RAM_PHYS_START        0x00000000
+#define MICRO_RAM_SIZE              0x00080000 //512KB
+#define MICRO_FLASH_PHYS_START      0x1D000000
+#define MICRO_FLASH_SIZE            0x00200000 //2MB
+#define MICRO_BOOT_FLASH_PHYS_START 0x1FC00000
+#define MICRO_BOOT_FLASH_SIZE       0x00074000
+#define MICRO_SFR_PHYS_START        0x1F800000
+#define MICRO_SFR_SIZE              0x00100000
 
 // +--------------------------------------------------------------+
 // |                        Public Globals                        |
@@ -46,19 +57,18 @@ extern u8  MicroDeviceRevision;
 // +--------------------------------------------------------------+
 void MicroInit();
 u8   MicroDetectResetCause();
+void MicroDelayCycles(u32 numCycles);
+void MicroDelayUs(u32 delayUs);
 void MicroDelay(u32 delayMs);
 void MicroReset();
+bool MicroIsValidMemoryRange(u32 address, u32 length, bool forWriting);
+bool MicroIsSfrAddress(u32 address);
 
 // +--------------------------------------------------------------+
 // |                          Pin Macros                          |
 // +--------------------------------------------------------------+
 
-//Output @TEST_LED1 H0 (Red)
-#define TEST_LED1_VALUE LATHbits.LATH0
-//Output @TEST_LED2 H1 (Yellow)
-#define TEST_LED2_VALUE LATHbits.LATH1
-//Output @TEST_LED3 H2 (Green)
-#define TEST_LED3_VALUE LATHbits.LATH2
+//NOTE: The test LEDs and test pins are listed in GPIO_OUTPUTS (gpio.h) so that writes to them are atomic
 
 //Input @TEST_BTN1 B12 (S1)
 #define TEST_BTN1_PULLUP CNPUBbits.CNPUB12
@@ -70,17 +80,4 @@ void MicroReset();
 #define TEST_BTN3_PULLUP CNPUBbits.CNPUB14
 #define TEST_BTN3_VALUE  PORTBbits.   RB14
 
-//Output @TEST_PIN1 K1
-#define TEST_PIN1_VALUE LATKbits.LATK1
-//Output @TEST_PIN2 K2
-#define TEST_PIN2_VALUE LATKbits.LATK2
-//Output @TEST_PIN3 K3
-#define TEST_PIN3_VALUE LATKbits.LATK3
-//Output @TEST_PIN4 K4
-#define TEST_PIN4_VALUE LATKbits.LATK4
-//Output @TEST_PIN5 K5
-#define TEST_PIN5_VALUE LATKbits.LATK5
-//Output @TEST_PIN6 K6
-#define TEST_PIN6_VALUE LATKbits.LATK6
-
 #endif //  _MICRO_H
@@ -0,0 +1,49 @@
+/*
+File:   oc_pwm.h
+Author: Taylor Robbins
+Date:   10\19\2026
+*/
+
+#ifndef _OC_PWM_H
+#define _OC_PWM_H
+
+// +--------------------------------------------------------------+
+// |                      Public Definitions                      |
+// +--------------------------------------------------------------+
+#define OC_PWM_DEFAULT_FREQUENCY 1000    //Hz
+#define OC_PWM_MIN_FREQUENCY     6       //Hz, one 16-bit Timer2 period at the 1:256 prescaler
+#define OC_PWM_MAX_FREQUENCY     1000000 //Hz, leaves 100 counts per period
+#define OC_PWM_MAX_DUTY          1000    //duty cycles are in tenths of a percent, 0 (always low) to OC_PWM_MAX_DUTY (always high)
+
+//NOTE: Add a line here (and the matching RPxxR mapping in MicroInit) to drive another header pin with an output compare module
+//              name, module, pin, header pin
+#define OC_PWM_CHANNELS(CHANNEL) \
+	CHANNEL(Oc1, 1, "RD0",  11) \
+	CHANNEL(Oc2, 2, "RF2",  12) \
+	CHANNEL(Oc3, 3, "RD10", 37) \
+	CHANNEL(Oc4, 4, "RB3",  15)
+
+// +--------------------------------------------------------------+
+// |                   Public Structures/Types                    |
+// +--------------------------------------------------------------+
+#define OC_PWM_ENUM_ENTRY(name, module, pinName, headerPin) OcPwm_##name,
+typedef enum
+{
+	OC_PWM_CHANNELS(OC_PWM_ENUM_ENTRY)
+	OcPwm_NumChannels,
+} OcPwmChannel_t;
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void OcPwmInit();
+bool OcPwmSetFrequency(u32 frequency);
+u32  OcPwmGetFrequency();
+void OcPwmSetDuty(OcPwmChannel_t channel, u16 duty);
+void OcPwmRelease(OcPwmChannel_t channel);
+bool OcPwmIsEnabled(OcPwmChannel_t channel);
+u16  OcPwmGetDuty(OcPwmChannel_t channel);
+bool OcPwmFindByName(const char* name, u32 nameLength, OcPwmChannel_t* channelOut);
+void OcPwmPrintChannels();
+
+#endif //  _OC_PWM_H
@@ -0,0 +1,52 @@
+/*
+File:   scheduler.h
+Author: Taylor Robbins
+Date:   10\19\2026
+*/
+
+#ifndef _SCHEDULER_H
+#define _SCHEDULER_H
+
+// +--------------------------------------------------------------+
+// |                      Public Definitions                      |
+// +--------------------------------------------------------------+
+#define MAX_NUM_TASKS 8
+#define SCHEDULER_MAX_DELAYED_CALLS 4
+#define SCHEDULER_IDLE_WINDOW_MS 1000 //How often the idle percentage is recalculated
+
+// +--------------------------------------------------------------+
+// |                   Public Structures/Types                    |
+// +--------------------------------------------------------------+
+typedef void (*TaskFunc_f)();
+
+typedef struct
+{
+	bool active;
+	const char* name;
+	TaskFunc_f function;
+	u32 periodMs;   //0 for background tasks which run round-robin whenever no periodic task is ready
+	u32 deadlineMs; //relative to the release time, 0 means the deadline is the end of the period
+	u8 priority;    //breaks ties between tasks with the same deadline, higher runs first
+	u32 releaseTimeMs;
+	
+	u32 numRuns;
+	u32 numOverruns; //times the task started after its deadline
+	u32 maxLatenessMs;
+	u64 totalCycles;
+	u32 maxCycles;
+} Task_t;
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void    SchedulerInit();
+Task_t* SchedulerAddTask(const char* name, TaskFunc_f function, u32 periodMs, u32 deadlineMs, u8 priority);
+bool    SchedulerRunAfter(TaskFunc_f function, u32 delayMs);
+void    SchedulerUpdate();
+void    SchedulerResetStats();
+void    SchedulerPrintTasks();
+void    SchedulerWake();
+void    SchedulerStayAwake();
+u32     SchedulerGetIdlePermille();
+
+#endif //  _SCHEDULER_H
@@ -0,0 +1,50 @@
+/*
+File:   soft_pwm.h
+Author: Taylor Robbins
+Date:   10\19\2026
+*/
+
+#ifndef _SOFT_PWM_H
+#define _SOFT_PWM_H
+
+// +--------------------------------------------------------------+
+// |                      Public Definitions                      |
+// +--------------------------------------------------------------+
+#define SOFT_PWM_FREQUENCY 1000 //Hz
+#define SOFT_PWM_MAX_DUTY  255  //duty cycles go from 0 (always low) to SOFT_PWM_MAX_DUTY (always high)
+#define SOFT_PWM_MAX_PORTS 2    //how many different ports the channels below can be spread across
+
+//NOTE: Add a line here to let a pin from GPIO_OUTPUTS (gpio.h) be driven by the software PWM
+#define SOFT_PWM_CHANNELS(CHANNEL) \
+	CHANNEL(TestLed1) \
+	CHANNEL(TestLed2) \
+	CHANNEL(TestLed3) \
+	CHANNEL(TestPin1) \
+	CHANNEL(TestPin2) \
+	CHANNEL(TestPin3) \
+	CHANNEL(TestPin4) \
+	CHANNEL(TestPin5) \
+	CHANNEL(TestPin6)
+
+// +--------------------------------------------------------------+
+// |                   Public Structures/Types                    |
+// +--------------------------------------------------------------+
+#define SOFT_PWM_ENUM_ENTRY(pinName) SoftPwm_##pinName,
+typedef enum
+{
+	SOFT_PWM_CHANNELS(SOFT_PWM_ENUM_ENTRY)
+	SoftPwm_NumChannels,
+} SoftPwmChannel_t;
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void SoftPwmInit();
+void SoftPwmSetDuty(SoftPwmChannel_t channel, u8 duty);
+void SoftPwmRelease(SoftPwmChannel_t channel);
+bool SoftPwmIsEnabled(SoftPwmChannel_t channel);
+u8   SoftPwmGetDuty(SoftPwmChannel_t channel);
+bool SoftPwmFindByName(const char* name, u32 nameLength, SoftPwmChannel_t* channelOut);
+void SoftPwmPrintChannels();
+
+#endif //  _SOFT_PWM_H
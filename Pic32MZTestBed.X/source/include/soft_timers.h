@@ -0,0 +1,52 @@
+/*
+File:   soft_timers.h
+Author: Taylor Robbins
+Date:   10\19\2026
+*/
+
+#ifndef _SOFT_TIMERS_H
+#define _SOFT_TIMERS_H
+
+// +--------------------------------------------------------------+
+// |                      Public Definitions                      |
+// +--------------------------------------------------------------+
+#define SOFT_TIMER_WHEEL_SIZE   64 //slots, must be a power of 2
+#define SOFT_TIMER_SHORT_PERIOD 5 //ms, periodic timers faster than this keep the tick timer out of tickless mode
+
+// +--------------------------------------------------------------+
+// |                   Public Structures/Types                    |
+// +--------------------------------------------------------------+
+typedef struct SoftTimer_t SoftTimer_t;
+typedef void (*SoftTimerCallback_f)(SoftTimer_t* timer);
+
+//NOTE: The owner of the timer provides the memory for it (usually a static global).
+//      A zeroed SoftTimer_t is a valid stopped timer so no init function is needed
+struct SoftTimer_t
+{
+	SoftTimer_t* next;
+	SoftTimer_t* prev;
+	bool running;
+	u32 expireTimeMs;
+	u32 periodMs; //0 for one-shot timers
+	SoftTimerCallback_f callback; //optional, called from the main loop when the timer expires
+	void* userPntr;
+};
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void SoftTimersInit();
+void SoftTimerStart(SoftTimer_t* timer, u32 delayMs, u32 periodMs, SoftTimerCallback_f callback, void* userPntr);
+void SoftTimerStop(SoftTimer_t* timer);
+bool SoftTimerIsRunning(const SoftTimer_t* timer);
+u32  SoftTimerRemainingMs(const SoftTimer_t* timer);
+u32  SoftTimersNumActive();
+void SoftTimersUpdate();
+
+// +--------------------------------------------------------------+
+// |                        Public Macros                         |
+// +--------------------------------------------------------------+
+#define SoftTimerStartOneShot(timer, delayMs)                    SoftTimerStart((timer), (delayMs), 0, nullptr, nullptr)
+#define SoftTimerStartPeriodic(timer, periodMs, callback, userPntr) SoftTimerStart((timer), (periodMs), (periodMs), (callback), (userPntr))
+
+#endif //  _SOFT_TIMERS_H
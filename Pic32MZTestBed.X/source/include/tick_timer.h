@@ -7,39 +7,117 @@ Date:   08\29\2019
 #ifndef _TICK_TIMER_H
 #define _TICK_TIMER_H
 
+// +--------------------------------------------------------------+
+// |                      Public Definitions                      |
+// +--------------------------------------------------------------+
+#define TICK_TIMER_MAX_TICKLESS_MS 20 //65535 timer counts at 3.125MHz is just under 21ms
+
+typedef enum
+{
+	TickPeriodicSource_SoftTimers = 0x01,
+	TickPeriodicSource_DebugRx    = 0x02,
+} TickPeriodicSource_t;
+
 // +--------------------------------------------------------------+
 // |                        Public Globals                        |
 // +--------------------------------------------------------------+
+//NOTE: TickCounterMs is only updated when the tick ISR runs, which can be up to
+//      TICK_TIMER_MAX_TICKLESS_MS apart in tickless mode. Use TickTimerGetMs() from the main loop
 extern volatile u32 TickCounterMs;  //Loops in 49.7 days
 extern volatile u32 TickCounterSec; //Loops in 136.19 years
+extern volatile u32 TickTimerIsrCount;
+extern volatile u32 TickTimerIsrsLastSecond;
+
+//NOTE: Timers are declared by adding a line to one of the lists below. Each list becomes an enum plus one array
+//      that TickTimerIsr updates in a single loop, so adding a timer never means touching the ISR.
+//      Countdowns stop at 0 (like DecrementAmount) and countups stop at 0xFFFFFFFF (like IncrementU32).
+//      In tickless mode the millisecond timers move by however many milliseconds the last period was.
 
 // +==============================+
 // |     Ms Countdown Timers      |
 // +==============================+
-extern volatile u32 DebugOutputBackoff;
-extern volatile u32 ButtonDebounceTimer1;
-extern volatile u32 ButtonDebounceTimer2;
-extern volatile u32 ButtonDebounceTimer3;
+//NOTE: Most millisecond countdowns should be SoftTimer_t's (see soft_timers.h) so something happens when they expire
+#define MS_COUNTDOWN_TIMERS(TIMER) \
+	/* none yet */
 
 // +==============================+
 // |      Ms Countup Timers       |
 // +==============================+
-//TODO: Add Ms Countup timers here
+#define MS_COUNTUP_TIMERS(TIMER) \
+	/* none yet */
 
 // +==============================+
 // |     Sec Countdown Timers     |
 // +==============================+
-//TODO: Add Sec Countdown timers here
+#define SEC_COUNTDOWN_TIMERS(TIMER) \
+	/* none yet */
 
 // +==============================+
 // |      Sec Countup Timers      |
 // +==============================+
-//TODO: Add Sec Countup timers here
+#define SEC_COUNTUP_TIMERS(TIMER) \
+	TIMER(LastCommand)
+
+#define TICK_TIMER_ENUM_ENTRY(prefix, name) prefix##_##name,
+#define MS_COUNTDOWN_ENUM_ENTRY(name)  TICK_TIMER_ENUM_ENTRY(MsCountdownTimer, name)
+#define MS_COUNTUP_ENUM_ENTRY(name)    TICK_TIMER_ENUM_ENTRY(MsCountupTimer, name)
+#define SEC_COUNTDOWN_ENUM_ENTRY(name) TICK_TIMER_ENUM_ENTRY(SecCountdownTimer, name)
+#define SEC_COUNTUP_ENUM_ENTRY(name)   TICK_TIMER_ENUM_ENTRY(SecCountupTimer, name)
+typedef enum { MS_COUNTDOWN_TIMERS(MS_COUNTDOWN_ENUM_ENTRY)   MsCountdownTimer_NumTimers  } MsCountdownTimer_t;
+typedef enum { MS_COUNTUP_TIMERS(MS_COUNTUP_ENUM_ENTRY)       MsCountupTimer_NumTimers    } MsCountupTimer_t;
+typedef enum { SEC_COUNTDOWN_TIMERS(SEC_COUNTDOWN_ENUM_ENTRY) SecCountdownTimer_NumTimers } SecCountdownTimer_t;
+typedef enum { SEC_COUNTUP_TIMERS(SEC_COUNTUP_ENUM_ENTRY)     SecCountupTimer_NumTimers   } SecCountupTimer_t;
+
+//The same counts as the NumTimers values above, but usable in #if so that an empty list doesn't declare a zero length array
+#define TICK_TIMER_COUNT_ENTRY(name) +1
+#define MS_COUNTDOWN_TIMER_COUNT  (0 MS_COUNTDOWN_TIMERS(TICK_TIMER_COUNT_ENTRY))
+#define MS_COUNTUP_TIMER_COUNT    (0 MS_COUNTUP_TIMERS(TICK_TIMER_COUNT_ENTRY))
+#define SEC_COUNTDOWN_TIMER_COUNT (0 SEC_COUNTDOWN_TIMERS(TICK_TIMER_COUNT_ENTRY))
+#define SEC_COUNTUP_TIMER_COUNT   (0 SEC_COUNTUP_TIMERS(TICK_TIMER_COUNT_ENTRY))
+
+#if (MS_COUNTDOWN_TIMER_COUNT > 0)
+extern volatile u32 MsCountdownTimers[MsCountdownTimer_NumTimers];
+#endif
+#if (MS_COUNTUP_TIMER_COUNT > 0)
+extern volatile u32 MsCountupTimers[MsCountupTimer_NumTimers];
+#endif
+#if (SEC_COUNTDOWN_TIMER_COUNT > 0)
+extern volatile u32 SecCountdownTimers[SecCountdownTimer_NumTimers];
+#endif
+#if (SEC_COUNTUP_TIMER_COUNT > 0)
+extern volatile u32 SecCountupTimers[SecCountupTimer_NumTimers];
+#endif
+
+//Use these to read or write a timer, ex: SecCountup(LastCommand) = 0;
+#define MsCountdown(name)  MsCountdownTimers[MsCountdownTimer_##name]
+#define MsCountup(name)    MsCountupTimers[MsCountupTimer_##name]
+#define SecCountdown(name) SecCountdownTimers[SecCountdownTimer_##name]
+#define SecCountup(name)   SecCountupTimers[SecCountupTimer_##name]
+
+// +--------------------------------------------------------------+
+// |                        Public Macros                         |
+// +--------------------------------------------------------------+
+#define TIME_CYCLES_PER_US (MICRO_SYS_CLK_FREQ / 2 / 1000000) //CP0 Count runs at SYSCLK/2
+
+//Wrap-safe comparisons for u32 millisecond (or second) timestamps. Only valid when the two are less than ~24.8 days apart
+#define TimeIsBefore(timeA, timeB)   ((i32)((u32)(timeA) - (u32)(timeB)) < 0)
+#define TimeIsAfter(timeA, timeB)    ((i32)((u32)(timeA) - (u32)(timeB)) > 0)
+#define TimeHasReached(now, deadline) ((i32)((u32)(now) - (u32)(deadline)) >= 0)
 
 // +--------------------------------------------------------------+
 // |                       Public Functions                       |
 // +--------------------------------------------------------------+
 void TickTimerInit();
+u32  TickTimerGetMs();
+void TickTimerSetTickless(bool enabled);
+bool TickTimerIsTickless();
+void TickTimerRequestPeriodic(TickPeriodicSource_t source, bool periodic);
+void TickTimerSetNextDeadline(u32 deadlineMs);
+void TickTimerGetLastTick(u32* tickMsOut, u64* cyclesOut);
+i32  TickTimerCalculateDriftPpm(u32 elapsedMs, u64 elapsedCycles);
+u64 TimeNowCycles();
+u64 TimeNowUs();
+u64 TimeSinceUs(u64 timeUs);
 u32 TimeSinceMs(u32 counterValueMs);
 u32 TimeSinceSec(u32 counterValueSec);
 
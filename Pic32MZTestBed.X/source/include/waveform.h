@@ -0,0 +1,43 @@
+/*
+File:   waveform.h
+Author: Taylor Robbins
+Date:   10\19\2026
+*/
+
+#ifndef _WAVEFORM_H
+#define _WAVEFORM_H
+
+// +--------------------------------------------------------------+
+// |                      Public Definitions                      |
+// +--------------------------------------------------------------+
+#define WAVEFORM_MAX_STEPS    64
+#define WAVEFORM_MIN_DELAY_US 5 //shorter steps can't be serviced reliably by the Timer4 ISR
+#define WAVEFORM_NUM_PINS     6 //TestPin1-6, bit 0 of a step's mask/value is TestPin1
+
+// +--------------------------------------------------------------+
+// |                   Public Structures/Types                    |
+// +--------------------------------------------------------------+
+typedef struct
+{
+	u8 pinMask;  //which test pins this step changes
+	u8 pinValue; //what to drive them to
+	u32 delayUs; //how long to wait before the next step
+	
+	//Filled in by WaveformAddStep so the ISR doesn't have to do any translating
+	u32 portMask;
+	u32 portValue;
+	u32 delayCounts;
+} WaveformStep_t;
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void WaveformInit();
+bool WaveformAddStep(u8 pinMask, u8 pinValue, u32 delayUs);
+void WaveformClear();
+bool WaveformPlay(u32 numLoops);
+void WaveformStop();
+bool WaveformIsPlaying();
+void WaveformPrintSteps();
+
+#endif //  _WAVEFORM_H
@@ -0,0 +1,44 @@
+/*
+File:   work_queue.h
+Author: Taylor Robbins
+Date:   10\19\2026
+*/
+
+#ifndef _WORK_QUEUE_H
+#define _WORK_QUEUE_H
+
+// +--------------------------------------------------------------+
+// |                      Public Definitions                      |
+// +--------------------------------------------------------------+
+#define WORK_QUEUE_SIZE 32 //items, must be a power of 2
+
+// +--------------------------------------------------------------+
+// |                   Public Structures/Types                    |
+// +--------------------------------------------------------------+
+typedef void (*WorkFunc_f)(u32 arg);
+
+typedef struct
+{
+	volatile u32 sequence; //tells producers and the consumer whose turn it is to use this slot
+	WorkFunc_f function;
+	u32 arg;
+} WorkItem_t;
+
+// +--------------------------------------------------------------+
+// |                        Public Globals                        |
+// +--------------------------------------------------------------+
+extern volatile u32 WorkQueueNumPosted;
+extern volatile u32 WorkQueueNumDropped;
+extern volatile u32 WorkQueueMaxDepth;
+extern u32 WorkQueueNumExecuted;
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void WorkQueueInit();
+bool WorkQueuePost(WorkFunc_f function, u32 arg);
+u32  WorkQueueDepth();
+void WorkQueueUpdate();
+void WorkQueueResetStats();
+
+#endif //  _WORK_QUEUE_H
@@ -0,0 +1,334 @@
+/*
+File:   input_capture.c
+Author: Taylor Robbins
+Date:   10\19\2026
+Description:
+	** Measures signals coming into the header pins in CAPTURE_CHANNELS with the input capture modules. The module
+	** latches Timer3 on every edge (rising edge first) in hardware, so the timestamps have 10ns resolution no matter how
+	** long the ISR takes to get to them, as long as it empties the 4 deep capture FIFO before it overflows.
+	
+	** Timer3 is only 16 bits (655us at PBCLK3) so its own interrupt counts the rollovers and the capture ISR puts the
+	** two together into a 32-bit timestamp (42s before it wraps). Both run at priority 5.1 so neither one can land in
+	** the middle of the other, and a capture ISR that finds a rollover still pending can tell which side of it an edge
+	** was on from the top bit of the captured value.
+	
+	** Only one channel captures at a time. Even edges in the buffer are rising and odd edges are falling, and the
+	** report/histogram are worked out from them in the main loop after the capture is finished
+*/
+
+#include "app.h"
+#include "input_capture.h"
+
+#include "micro.h"
+#include "debug.h"
+#include "work_queue.h"
+
+// +--------------------------------------------------------------+
+// |                     Private Definitions                      |
+// +--------------------------------------------------------------+
+#define CAPTURE_NS_PER_COUNT   (1000000000 / MICRO_PERF_BUS3_FREQ) //Timer3 runs at PBCLK3 with no prescaler
+#define CAPTURE_ICM_EVERY_EDGE 0b110 //every edge, starting with the one FEDGE picks
+#define CAPTURE_TIME_STR_SIZE  16
+
+#if ((1000000000 % MICRO_PERF_BUS3_FREQ) != 0)
+#error PBCLK3 period is not a whole number of nanoseconds
+#endif
+
+typedef struct
+{
+	const char* name;
+	const char* pinName;
+	u8 headerPin;
+	u32 intMask; //IFS0/IEC0
+	volatile unsigned int* conReg;
+	volatile unsigned int* conClrReg;
+	volatile unsigned int* bufReg;
+} CaptureModule_t;
+
+typedef struct
+{
+	u32 numSamples;
+	u32 minCounts;
+	u32 maxCounts;
+	u64 totalCounts;
+} CaptureStat_t;
+
+typedef enum
+{
+	CaptureStopReason_Stopped  = 0x00,
+	CaptureStopReason_Full     = 0x01,
+	CaptureStopReason_Overflow = 0x02,
+} CaptureStopReason_t;
+
+// +--------------------------------------------------------------+
+// |                       Private Globals                        |
+// +--------------------------------------------------------------+
+#define CAPTURE_MODULE_ENTRY(name, module, pinName, headerPin) { "IC" #module, pinName, headerPin, _IFS0_IC##module##IF_MASK, &IC##module##CON, &IC##module##CONCLR, &IC##module##BUF },
+static const CaptureModule_t Modules[Capture_NumChannels] = { CAPTURE_CHANNELS(CAPTURE_MODULE_ENTRY) };
+
+static u32 Edges[CAPTURE_BUFFER_SIZE];
+static volatile u32 numEdges = 0;
+static u32 edgesToCapture = 0;
+static const CaptureModule_t* activeModule = nullptr;
+static volatile u32 timerOverflows = 0;
+static volatile bool running = false;
+static volatile CaptureStopReason_t stopReason = CaptureStopReason_Stopped;
+
+// +--------------------------------------------------------------+
+// |                      Private Functions                       |
+// +--------------------------------------------------------------+
+static void CaptureReportDone(u32 reason)
+{
+	if (reason == CaptureStopReason_Overflow) { PrintLine_W("Input capture stopped after %u edges, the edges came faster than the ISR could keep up with", numEdges); }
+	else { PrintLine_I("Input capture finished, %u edges", numEdges); }
+}
+
+//NOTE: Called from the ISRs and CaptureStop
+static void CaptureFinish(CaptureStopReason_t reason)
+{
+	if (activeModule != nullptr)
+	{
+		*activeModule->conClrReg = _IC1CON_ON_MASK;
+		IEC0CLR = activeModule->intMask;
+		IFS0CLR = activeModule->intMask;
+	}
+	T3CONCLR = _T3CON_ON_MASK;
+	IEC0CLR = _IEC0_T3IE_MASK;
+	IFS0CLR = _IFS0_T3IF_MASK;
+	stopReason = reason;
+	running = false;
+}
+
+static const char* CaptureFormatTime(char* buffer, u32 numCounts)
+{
+	u64 numNs = (u64)numCounts * CAPTURE_NS_PER_COUNT;
+	snprintf(buffer, CAPTURE_TIME_STR_SIZE, "%u.%02uus", (u32)(numNs / 1000), (u32)((numNs % 1000) / 10));
+	return buffer;
+}
+
+static u32 CaptureNumSamples(CaptureMeasure_t measure, u32 edgeCount)
+{
+	if (measure == CaptureMeasure_High) { return edgeCount / 2; }
+	return (edgeCount > 0) ? (edgeCount - 1) / 2 : 0;
+}
+
+static u32 CaptureGetSample(CaptureMeasure_t measure, u32 sIndex)
+{
+	u32 riseIndex = sIndex * 2;
+	switch (measure)
+	{
+		case CaptureMeasure_Period: return Edges[riseIndex + 2] - Edges[riseIndex];
+		case CaptureMeasure_High:   return Edges[riseIndex + 1] - Edges[riseIndex];
+		case CaptureMeasure_Low:    return Edges[riseIndex + 2] - Edges[riseIndex + 1];
+		default: return 0;
+	}
+}
+
+static void CaptureCalcStat(CaptureMeasure_t measure, u32 edgeCount, CaptureStat_t* stat)
+{
+	ClearPointer(stat);
+	u32 numSamples = CaptureNumSamples(measure, edgeCount);
+	u32 sIndex;
+	for (sIndex = 0; sIndex < numSamples; sIndex++)
+	{
+		u32 numCounts = CaptureGetSample(measure, sIndex);
+		if (stat->numSamples == 0 || numCounts < stat->minCounts) { stat->minCounts = numCounts; }
+		if (numCounts > stat->maxCounts) { stat->maxCounts = numCounts; }
+		stat->totalCounts += numCounts;
+		stat->numSamples++;
+	}
+}
+
+static void CapturePrintStat(const char* name, const CaptureStat_t* stat)
+{
+	char minStr[CAPTURE_TIME_STR_SIZE];
+	char avgStr[CAPTURE_TIME_STR_SIZE];
+	char maxStr[CAPTURE_TIME_STR_SIZE];
+	if (stat->numSamples == 0) { PrintLine_I("  %-7s none captured", name); return; }
+	PrintLine_I("  %-7s min %-12s avg %-12s max %-12s (%u)", name,
+		CaptureFormatTime(minStr, stat->minCounts), CaptureFormatTime(avgStr, (u32)(stat->totalCounts / stat->numSamples)),
+		CaptureFormatTime(maxStr, stat->maxCounts), stat->numSamples
+	);
+}
+
+//NOTE: Only called from the capture ISRs. Everything runs at priority 5 so Timer3's ISR can't change timerOverflows under us
+static inline void CaptureDrainFifo()
+{
+	const CaptureModule_t* module = activeModule;
+	IFS0CLR = module->intMask; //clear first so an edge that lands while we're draining isn't lost
+	while (IsFlagSet(*module->conReg, _IC1CON_ICBNE_MASK))
+	{
+		u32 captured = (*module->bufReg & 0xFFFF);
+		u32 upper = timerOverflows;
+		//Timer3 rolled over but its ISR hasn't run yet. Small values were captured after the rollover
+		if (IsFlagSet(IFS0, _IFS0_T3IF_MASK) && captured < 0x8000) { upper++; }
+		if (numEdges < edgesToCapture) { Edges[numEdges] = (upper << 16) | captured; numEdges++; }
+	}
+	if (IsFlagSet(*module->conReg, _IC1CON_ICOV_MASK)) { CaptureFinish(CaptureStopReason_Overflow); WorkQueuePost(CaptureReportDone, CaptureStopReason_Overflow); }
+	else if (numEdges >= edgesToCapture) { CaptureFinish(CaptureStopReason_Full); WorkQueuePost(CaptureReportDone, CaptureStopReason_Full); }
+}
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void CaptureInit()
+{
+	ClearArray(Edges);
+	numEdges = 0;
+	activeModule = nullptr;
+	running = false;
+	
+	u32 cIndex;
+	for (cIndex = 0; cIndex < Capture_NumChannels; cIndex++)
+	{
+		*Modules[cIndex].conReg = 0x0000;
+	}
+	IPC1bits.IC1IP = 5; IPC1bits.IC1IS = 1; //Int priority 5.1, same as Timer3 below
+	IPC2bits.IC2IP = 5; IPC2bits.IC2IS = 1;
+	IPC4bits.IC3IP = 5; IPC4bits.IC3IS = 1;
+	IPC7bits.IC6IP = 5; IPC7bits.IC6IS = 1;
+	
+	//+===============================+
+	//|         Timer3 Init           |
+	//+===============================+
+	T3CON = 0x0000;
+	T3CONbits.SIDL  = 0; // Continue in idle mode.
+	T3CONbits.TCKPS = 0b000; // No pre-scaler, one count per PBCLK3 period
+	PR3 = 0xFFFF;
+	IPC3bits.T3IP = 5; IPC3bits.T3IS = 1; //Int priority 5.1
+	IFS0bits.T3IF = CLEARED;
+	IEC0bits.T3IE = DISABLED;
+}
+
+bool CaptureStart(CaptureChannel_t channel, u32 maxEdges)
+{
+	Assert(channel < Capture_NumChannels);
+	if (maxEdges == 0 || maxEdges > CAPTURE_BUFFER_SIZE) { maxEdges = CAPTURE_BUFFER_SIZE; }
+	CaptureStop();
+	
+	const CaptureModule_t* module = &Modules[channel];
+	activeModule = module;
+	edgesToCapture = maxEdges;
+	numEdges = 0;
+	timerOverflows = 0;
+	stopReason = CaptureStopReason_Stopped;
+	running = true;
+	
+	//ICTMR = 0 (Timer3), ICI = 0 (interrupt on every capture), 16-bit, rising edge first
+	*module->conReg = (CAPTURE_ICM_EVERY_EDGE << _IC1CON_ICM_POSITION) | _IC1CON_FEDGE_MASK;
+	TMR3 = 0;
+	IFS0CLR = _IFS0_T3IF_MASK | module->intMask;
+	IEC0SET = _IEC0_T3IE_MASK | module->intMask;
+	T3CONSET = _T3CON_ON_MASK;
+	*module->conReg |= _IC1CON_ON_MASK;
+	return true;
+}
+
+void CaptureStop()
+{
+	if (!running) { return; }
+	CaptureFinish(CaptureStopReason_Stopped);
+}
+
+bool CaptureIsRunning()
+{
+	return running;
+}
+
+//NOTE: Accepts either the module name (ex. IC1) or the pin it's mapped to (ex. RD1)
+bool CaptureFindByName(const char* name, u32 nameLength, CaptureChannel_t* channelOut)
+{
+	u32 cIndex;
+	for (cIndex = 0; cIndex < Capture_NumChannels; cIndex++)
+	{
+		const CaptureModule_t* module = &Modules[cIndex];
+		if ((strlen(module->name) == nameLength && strncmp(module->name, name, nameLength) == 0) ||
+			(strlen(module->pinName) == nameLength && strncmp(module->pinName, name, nameLength) == 0))
+		{
+			if (channelOut != nullptr) { *channelOut = (CaptureChannel_t)cIndex; }
+			return true;
+		}
+	}
+	return false;
+}
+
+void CapturePrintReport()
+{
+	if (activeModule == nullptr)
+	{
+		WriteLine_I("No input capture has been started. Channels:");
+		u32 cIndex;
+		for (cIndex = 0; cIndex < Capture_NumChannels; cIndex++)
+		{
+			PrintLine_I("  %s %-4s (header pin %u)", Modules[cIndex].name, Modules[cIndex].pinName, Modules[cIndex].headerPin);
+		}
+		return;
+	}
+	
+	u32 edgeCount = numEdges;
+	if (running) { PrintLine_I("%s (%s) capturing, %u/%u edges so far", activeModule->name, activeModule->pinName, edgeCount, edgesToCapture); }
+	else if (stopReason == CaptureStopReason_Overflow) { PrintLine_W("%s (%s) captured %u edges before the capture FIFO overflowed", activeModule->name, activeModule->pinName, edgeCount); }
+	else { PrintLine_I("%s (%s) captured %u edges", activeModule->name, activeModule->pinName, edgeCount); }
+	
+	CaptureStat_t periodStat;
+	CaptureStat_t highStat;
+	CaptureStat_t lowStat;
+	CaptureCalcStat(CaptureMeasure_Period, edgeCount, &periodStat);
+	CaptureCalcStat(CaptureMeasure_High, edgeCount, &highStat);
+	CaptureCalcStat(CaptureMeasure_Low, edgeCount, &lowStat);
+	if (periodStat.numSamples == 0) { WriteLine_I("Need at least 3 edges for a full period"); }
+	else
+	{
+		//Duty only counts high times that are part of a full period
+		u64 periodHighCounts = periodStat.totalCounts - lowStat.totalCounts;
+		u32 milliHz = (u32)(((u64)MICRO_PERF_BUS3_FREQ * 1000 * periodStat.numSamples) / periodStat.totalCounts);
+		u32 dutyX10 = (u32)((periodHighCounts * 1000) / periodStat.totalCounts);
+		PrintLine_I("Frequency %u.%03uHz, duty %u.%u%%", milliHz / 1000, milliHz % 1000, dutyX10 / 10, dutyX10 % 10);
+	}
+	CapturePrintStat("Period", &periodStat);
+	CapturePrintStat("High", &highStat);
+	CapturePrintStat("Low", &lowStat);
+}
+
+void CapturePrintHistogram(CaptureMeasure_t measure)
+{
+	u32 edgeCount = numEdges;
+	CaptureStat_t stat;
+	CaptureCalcStat(measure, edgeCount, &stat);
+	if (stat.numSamples == 0) { WriteLine_I("Nothing captured to make a histogram from"); return; }
+	
+	u32 Bins[CAPTURE_HISTOGRAM_BINS];
+	ClearArray(Bins);
+	u32 binWidth = ((stat.maxCounts - stat.minCounts) / CAPTURE_HISTOGRAM_BINS) + 1;
+	u32 numSamples = CaptureNumSamples(measure, edgeCount);
+	u32 sIndex;
+	for (sIndex = 0; sIndex < numSamples; sIndex++)
+	{
+		Bins[(CaptureGetSample(measure, sIndex) - stat.minCounts) / binWidth]++;
+	}
+	u32 maxBin = 0;
+	u32 bIndex;
+	for (bIndex = 0; bIndex < CAPTURE_HISTOGRAM_BINS; bIndex++) { if (Bins[bIndex] > maxBin) { maxBin = Bins[bIndex]; } }
+	
+	char bar[CAPTURE_HISTOGRAM_WIDTH + 1];
+	char startStr[CAPTURE_TIME_STR_SIZE];
+	for (bIndex = 0; bIndex < CAPTURE_HISTOGRAM_BINS; bIndex++)
+	{
+		u32 barLength = (Bins[bIndex] * CAPTURE_HISTOGRAM_WIDTH + maxBin - 1) / maxBin; //round up so any count shows
+		memset(bar, '#', barLength);
+		bar[barLength] = '\0';
+		PrintLine_I("  %12s |%-*s %u", CaptureFormatTime(startStr, stat.minCounts + bIndex * binWidth), CAPTURE_HISTOGRAM_WIDTH, bar, Bins[bIndex]);
+	}
+}
+
+// +--------------------------------------------------------------+
+// |                       Capture ISRs                           |
+// +--------------------------------------------------------------+
+void __ISR(_TIMER_3_VECTOR, ipl5AUTO) CaptureTimerIsr()
+{
+	IFS0CLR = _IFS0_T3IF_MASK;
+	timerOverflows++;
+}
+
+#define CAPTURE_ISR_ENTRY(name, module, pinName, headerPin) void __ISR(_INPUT_CAPTURE_##module##_VECTOR, ipl5AUTO) Capture##name##Isr() { CaptureDrainFifo(); }
+CAPTURE_CHANNELS(CAPTURE_ISR_ENTRY)
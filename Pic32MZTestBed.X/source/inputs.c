@@ -0,0 +1,226 @@
+/*
+File:   inputs.c
+Author: Taylor Robbins
+Date:   10\19\2026
+Description:
+	** Holds a small input engine for buttons (and anything else that acts like one) declared in the INPUT_PINS table
+	** The PORTB change notification interrupt records every edge along with a timestamp in a queue. InputsUpdate runs in
+	** the main loop and turns those edges into debounced Pressed/Released events that the application pops with InputsPopEvent
+	
+	** Debouncing works the same way the old AppUpdate code did: the first edge is accepted right away and then the input
+	** ignores edges for BUTTON_DEBOUNCE_TIME. When that lockout expires we look at the pin again in case it settled in
+	** the other state while we weren't listening.
+	
+	** Every raw edge (bounces included) also goes into the edge log with a CP0 cycle timestamp, see edge_log.c
+*/
+
+#include "app.h"
+#include "inputs.h"
+
+#include "micro.h"
+#include "debug.h"
+#include "tick_timer.h"
+#include "soft_timers.h"
+#include "scheduler.h"
+#include "edge_log.h"
+
+// +--------------------------------------------------------------+
+// |                   Private Structures/Types                   |
+// +--------------------------------------------------------------+
+typedef struct
+{
+	u32 mask; //bit in PORTB
+	bool activeLow;
+	const char* name;
+} InputPin_t;
+
+typedef struct
+{
+	u8 input;
+	bool isDown;
+	u32 timeMs;
+} InputEdge_t;
+
+typedef struct
+{
+	bool isDown; //debounced
+	bool recheckPending;
+	u32 lastChangeTimeMs;
+	SoftTimer_t lockoutTimer;
+} InputState_t;
+
+// +--------------------------------------------------------------+
+// |                     Private Definitions                      |
+// +--------------------------------------------------------------+
+#define INPUT_PIN_ENTRY(name, bit, activeLow) { (1UL << (bit)), (activeLow), #name },
+#define INPUT_MASK_ENTRY(name, bit, activeLow) (1UL << (bit)) |
+#define INPUTS_CN_MASK (INPUT_PINS(INPUT_MASK_ENTRY) 0)
+
+#if ((INPUT_EDGE_QUEUE_SIZE & (INPUT_EDGE_QUEUE_SIZE-1)) != 0 || (INPUT_EVENT_QUEUE_SIZE & (INPUT_EVENT_QUEUE_SIZE-1)) != 0)
+#error The input queue sizes must be powers of 2
+#endif
+
+// +--------------------------------------------------------------+
+// |                        Public Globals                        |
+// +--------------------------------------------------------------+
+volatile u32 InputsEdgeOverflowCount = 0;
+u32 InputsEventOverflowCount = 0;
+
+// +--------------------------------------------------------------+
+// |                       Private Globals                        |
+// +--------------------------------------------------------------+
+static const InputPin_t InputPins[Input_NumInputs] = { INPUT_PINS(INPUT_PIN_ENTRY) };
+static InputState_t InputStates[Input_NumInputs];
+
+static InputEdge_t edgeQueue[INPUT_EDGE_QUEUE_SIZE];
+static volatile u32 edgeQueueHead = 0; //written by the ISR
+static volatile u32 edgeQueueTail = 0; //written by InputsUpdate
+
+static InputEvent_t eventQueue[INPUT_EVENT_QUEUE_SIZE];
+static u32 eventQueueHead = 0;
+static u32 eventQueueTail = 0;
+
+// +--------------------------------------------------------------+
+// |                      Private Functions                       |
+// +--------------------------------------------------------------+
+static bool InputPinIsDown(Input_t input, u32 portValue)
+{
+	bool isHigh = ((portValue & InputPins[input].mask) != 0);
+	return InputPins[input].activeLow ? !isHigh : isHigh;
+}
+
+static void InputAcceptChange(Input_t input, bool isDown, u32 timeMs)
+{
+	InputState_t* state = &InputStates[input];
+	
+	if (eventQueueHead - eventQueueTail < INPUT_EVENT_QUEUE_SIZE)
+	{
+		InputEvent_t* event = &eventQueue[eventQueueHead % INPUT_EVENT_QUEUE_SIZE];
+		event->input = input;
+		event->type = isDown ? InputEventType_Pressed : InputEventType_Released;
+		event->timeMs = timeMs;
+		event->durationMs = timeMs - state->lastChangeTimeMs;
+		eventQueueHead++;
+	}
+	else { InputsEventOverflowCount++; }
+	
+	state->isDown = isDown;
+	state->lastChangeTimeMs = timeMs;
+	state->recheckPending = true;
+	SoftTimerStartOneShot(&state->lockoutTimer, BUTTON_DEBOUNCE_TIME);
+}
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void InputsInit()
+{
+	ClearArray(InputStates);
+	edgeQueueHead = 0;
+	edgeQueueTail = 0;
+	eventQueueHead = 0;
+	eventQueueTail = 0;
+	
+	u32 portValue = PORTB;
+	u32 currentTimeMs = TickTimerGetMs();
+	u32 iIndex;
+	for (iIndex = 0; iIndex < Input_NumInputs; iIndex++)
+	{
+		InputStates[iIndex].isDown = InputPinIsDown((Input_t)iIndex, portValue);
+		InputStates[iIndex].lastChangeTimeMs = currentTimeMs;
+	}
+	
+	CNCONBbits.EDGEDETECT = ENABLED;
+	CNENBSET = INPUTS_CN_MASK; //rising edges
+	CNNEBSET = INPUTS_CN_MASK; //falling edges
+	CNFBCLR  = INPUTS_CN_MASK;
+	CNCONBbits.ON = ENABLED;
+	IPC29bits.CNBIP = 1; IPC29bits.CNBIS = 0; //Int priority 1.0
+	IFS3bits.CNBIF = CLEARED;
+	IEC3bits.CNBIE = ENABLED;
+}
+
+void InputsUpdate()
+{
+	// +==============================+
+	// |       Handle Raw Edges       |
+	// +==============================+
+	while (edgeQueueTail != edgeQueueHead)
+	{
+		const InputEdge_t* edge = &edgeQueue[edgeQueueTail % INPUT_EDGE_QUEUE_SIZE];
+		Input_t input = (Input_t)edge->input;
+		InputState_t* state = &InputStates[input];
+		//Edges during the lockout are bounces. We look at the pin again once it's over
+		if (!SoftTimerIsRunning(&state->lockoutTimer) && edge->isDown != state->isDown)
+		{
+			InputAcceptChange(input, edge->isDown, edge->timeMs);
+		}
+		edgeQueueTail++;
+	}
+	
+	// +==============================+
+	// |     Recheck After Lockout    |
+	// +==============================+
+	u32 iIndex;
+	for (iIndex = 0; iIndex < Input_NumInputs; iIndex++)
+	{
+		InputState_t* state = &InputStates[iIndex];
+		if (state->recheckPending && !SoftTimerIsRunning(&state->lockoutTimer))
+		{
+			state->recheckPending = false;
+			bool isDown = InputPinIsDown((Input_t)iIndex, PORTB);
+			if (isDown != state->isDown) { InputAcceptChange((Input_t)iIndex, isDown, TickTimerGetMs()); }
+		}
+	}
+}
+
+bool InputsPopEvent(InputEvent_t* eventOut)
+{
+	Assert(eventOut != nullptr);
+	if (eventQueueTail == eventQueueHead) { return false; }
+	memcpy(eventOut, &eventQueue[eventQueueTail % INPUT_EVENT_QUEUE_SIZE], sizeof(InputEvent_t));
+	eventQueueTail++;
+	return true;
+}
+
+bool InputIsDown(Input_t input)
+{
+	Assert(input < Input_NumInputs);
+	return InputStates[input].isDown;
+}
+
+const char* GetInputName(Input_t input)
+{
+	if (input >= Input_NumInputs) { return "Unknown"; }
+	return InputPins[input].name;
+}
+
+// +--------------------------------------------------------------+
+// |                Change Notification (PORTB) ISR               |
+// +--------------------------------------------------------------+
+void __ISR(_CHANGE_NOTICE_B_VECTOR, ipl1AUTO) InputsChangeIsr()
+{
+	u64 edgeCycles = TimeNowCycles(); //first, so the time we spend in here doesn't end up in the edge log
+	//Clear the flag before reading CNFB so an edge that lands after the read sets it again instead of getting lost
+	IFS3CLR = _IFS3_CNBIF_MASK;
+	u32 changedMask = CNFB & INPUTS_CN_MASK;
+	u32 portValue = PORTB;
+	CNFBCLR = changedMask;
+	
+	u32 currentTimeMs = TickTimerGetMs();
+	u32 iIndex;
+	for (iIndex = 0; iIndex < Input_NumInputs; iIndex++)
+	{
+		if ((changedMask & InputPins[iIndex].mask) == 0) { continue; }
+		bool isDown = InputPinIsDown((Input_t)iIndex, portValue);
+		EdgeLogRecord((u8)iIndex, isDown, (u16)portValue, edgeCycles);
+		if (edgeQueueHead - edgeQueueTail >= INPUT_EDGE_QUEUE_SIZE) { InputsEdgeOverflowCount++; continue; }
+		InputEdge_t* edge = &edgeQueue[edgeQueueHead % INPUT_EDGE_QUEUE_SIZE];
+		edge->input = (u8)iIndex;
+		edge->isDown = isDown;
+		edge->timeMs = currentTimeMs;
+		edgeQueueHead++;
+	}
+	
+	SchedulerWake();
+}
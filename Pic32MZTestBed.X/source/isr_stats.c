@@ -0,0 +1,92 @@
+/*
+File:   isr_stats.c
+Author: Taylor Robbins
+Date:   10\19\2026
+Description:
+	** Collects interrupt latency histograms so we can see how late our ISRs actually run
+	** Each ISR works out how long ago the event it is servicing happened and passes that to IsrStatsRecord:
+	**   TickTimerIsr uses TMR9, which has been counting since the period ended
+	**   DebugUartRxIsr (or the DMA ISR) only knows the event time when DebugUartRxIdleTick forced the interrupt
+	**   DebugUartTxIsr measures from the moment DebugUartTxPut re-enabled the Tx interrupt
+	** The buckets are powers of 2 so a handful of u32's covers everything from a few cycles up to hundreds of microseconds
+	
+	** Everything compiles away when ISR_STATS_ENABLED is false. The "isrstat" command prints the results
+*/
+
+#include "app.h"
+#include "isr_stats.h"
+
+#include "micro.h"
+#include "debug.h"
+#include "tick_timer.h"
+
+// +--------------------------------------------------------------+
+// |                     Private Definitions                      |
+// +--------------------------------------------------------------+
+#define ISR_STATS_NS_PER_CYCLE (1000 / TIME_CYCLES_PER_US)
+
+// +--------------------------------------------------------------+
+// |                       Private Globals                        |
+// +--------------------------------------------------------------+
+#if ISR_STATS_ENABLED
+static const char* isrStatNames[IsrStatId_NumIds] = { "TickTimer", "DebugRx", "DebugTx" };
+#endif
+static volatile IsrStat_t isrStats[IsrStatId_NumIds];
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+#if ISR_STATS_ENABLED
+//NOTE: Called from inside ISRs of different priorities so it has to be atomic
+void IsrStatsRecord(IsrStatId_t statId, u32 latencyCycles)
+{
+	u32 bucketIndex = (latencyCycles == 0) ? 0 : (32 - __builtin_clz(latencyCycles));
+	if (bucketIndex >= ISR_STATS_NUM_BUCKETS) { bucketIndex = ISR_STATS_NUM_BUCKETS-1; }
+	
+	MicroDisableInterrupts();
+	volatile IsrStat_t* stat = &isrStats[statId];
+	if (stat->numSamples == 0 || latencyCycles < stat->minCycles) { stat->minCycles = latencyCycles; }
+	if (latencyCycles > stat->maxCycles) { stat->maxCycles = latencyCycles; }
+	stat->numSamples++;
+	stat->buckets[bucketIndex]++;
+	MicroEnableInterrupts();
+}
+#endif
+
+void IsrStatsReset()
+{
+	MicroDisableInterrupts();
+	memset((void*)&isrStats[0], 0x00, sizeof(isrStats));
+	MicroEnableInterrupts();
+}
+
+void IsrStatsPrint()
+{
+	#if ISR_STATS_ENABLED
+	u32 sIndex;
+	for (sIndex = 0; sIndex < IsrStatId_NumIds; sIndex++)
+	{
+		IsrStat_t stat;
+		MicroDisableInterrupts();
+		memcpy(&stat, (const void*)&isrStats[sIndex], sizeof(stat));
+		MicroEnableInterrupts();
+		
+		if (stat.numSamples == 0) { PrintLine_I("%s: No samples", isrStatNames[sIndex]); continue; }
+		PrintLine_I("%s: %u samples, min %uns, max %uns, jitter %uns", isrStatNames[sIndex], stat.numSamples,
+			stat.minCycles * ISR_STATS_NS_PER_CYCLE,
+			stat.maxCycles * ISR_STATS_NS_PER_CYCLE,
+			(stat.maxCycles - stat.minCycles) * ISR_STATS_NS_PER_CYCLE
+		);
+		u32 bIndex;
+		for (bIndex = 0; bIndex < ISR_STATS_NUM_BUCKETS; bIndex++)
+		{
+			if (stat.buckets[bIndex] == 0) { continue; }
+			u32 upperNs = (1UL << bIndex) * ISR_STATS_NS_PER_CYCLE;
+			if (bIndex == ISR_STATS_NUM_BUCKETS-1) { PrintLine_I("  >= %6uns: %u", upperNs / 2, stat.buckets[bIndex]); }
+			else { PrintLine_I("  <  %6uns: %u", upperNs, stat.buckets[bIndex]); }
+		}
+	}
+	#else
+	WriteLine_W("ISR statistics are disabled. Set ISR_STATS_ENABLED to true");
+	#endif
+}
@@ -0,0 +1,122 @@
+/*
+File:   jobs.c
+Author: Taylor Robbins
+Date:   10\19\2026
+Description:
+	** Holds a small cooperative job system that lets long running debug commands do their work a little bit at a time
+	** Each job is a function that gets called once per pass of the main loop until it returns JobResult_Done.
+	** The job keeps any state it needs between passes inside the Job_t structure (state, args and userPntr)
+	
+	** Jobs can be killed using JobKill. The job function is called one last time with killRequested set
+	** so that it can clean up anything it was doing (turn off peripherals, stop output, etc.)
+*/
+
+#include "app.h"
+#include "jobs.h"
+
+#include "debug.h"
+#include "tick_timer.h"
+#include "scheduler.h"
+
+// +--------------------------------------------------------------+
+// |                       Private Globals                        |
+// +--------------------------------------------------------------+
+static Job_t Jobs[MAX_NUM_JOBS];
+static u32 nextJobId = 1;
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void JobsInit()
+{
+	ClearArray(Jobs);
+	nextJobId = 1;
+}
+
+Job_t* JobStart(const char* name, JobFunc_f function)
+{
+	Assert(function != nullptr);
+	
+	u32 jIndex;
+	for (jIndex = 0; jIndex < MAX_NUM_JOBS; jIndex++)
+	{
+		Job_t* job = &Jobs[jIndex];
+		if (!job->active)
+		{
+			ClearPointer(job);
+			job->active = true;
+			job->id = nextJobId;
+			job->name = (name != nullptr) ? name : "job";
+			job->function = function;
+			job->startTimeMs = TickTimerGetMs();
+			nextJobId++;
+			return job;
+		}
+	}
+	
+	PrintLine_E("Can't start \"%s\". All %u job slots are in use", (name != nullptr) ? name : "job", MAX_NUM_JOBS);
+	return nullptr;
+}
+
+bool JobKill(u32 jobId)
+{
+	u32 jIndex;
+	for (jIndex = 0; jIndex < MAX_NUM_JOBS; jIndex++)
+	{
+		Job_t* job = &Jobs[jIndex];
+		if (job->active && job->id == jobId)
+		{
+			job->killRequested = true;
+			return true;
+		}
+	}
+	return false;
+}
+
+u32 JobsNumActive()
+{
+	u32 result = 0;
+	u32 jIndex;
+	for (jIndex = 0; jIndex < MAX_NUM_JOBS; jIndex++)
+	{
+		if (Jobs[jIndex].active) { result++; }
+	}
+	return result;
+}
+
+void JobsPrintList()
+{
+	if (JobsNumActive() == 0) { WriteLine_I("No jobs running"); return; }
+	
+	u32 jIndex;
+	for (jIndex = 0; jIndex < MAX_NUM_JOBS; jIndex++)
+	{
+		const Job_t* job = &Jobs[jIndex];
+		if (job->active)
+		{
+			PrintLine_I("[%u] %s: %u passes, running for %ums%s", job->id, job->name, job->numPasses, TimeSinceMs(job->startTimeMs), job->killRequested ? " (killing)" : "");
+		}
+	}
+}
+
+void JobsUpdate()
+{
+	u32 jIndex;
+	for (jIndex = 0; jIndex < MAX_NUM_JOBS; jIndex++)
+	{
+		Job_t* job = &Jobs[jIndex];
+		if (job->active)
+		{
+			JobResult_t result = job->function(job);
+			job->numPasses++;
+			if (result == JobResult_Done || job->killRequested)
+			{
+				if (job->killRequested) { PrintLine_W("[%u] %s killed", job->id, job->name); }
+				job->active = false;
+			}
+		}
+	}
+	
+	//Jobs poll for their conditions so don't let the main loop WAIT while any are running
+	if (JobsNumActive() > 0) { SchedulerStayAwake(); }
+}
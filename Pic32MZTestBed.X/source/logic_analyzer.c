@@ -0,0 +1,346 @@
+/*
+File:   logic_analyzer.c
+Author: Taylor Robbins
+Date:   10\19\2026
+Description:
+	** Turns the test bed into a small logic analyzer. The Timer6 ISR samples one GPIO port at a fixed rate and keeps
+	** the bits in captureMask. Samples that read the same as the one before just make the current run longer, so only
+	** changes take up space in the ring buffer (a quiet bus can be captured for a long time).
+	
+	** A capture can wait for a trigger before it starts: a pattern on the same port ((PORTx & mask) == value) or any
+	** edge on the pins in the trigger mask. Nothing from before the trigger is kept.
+	
+	** LogicVcdJob sends the runs to the host as a Value Change Dump (VCD) file that PulseView, GTKWave, etc. can open.
+	** The VCD text is written raw (no output level prefix) from a "VCD BEGIN" line to a "VCD END" line. The job frees
+	** up ring entries as it sends them so it can run while a capture is still going, as long as the UART keeps up.
+	** Debug output is held (DebugUartHoldOutput) for the whole upload so button events, reports, echo, etc. can't end up
+	** in the middle of the file. They come out after "VCD END"
+*/
+
+#include "app.h"
+#include "logic_analyzer.h"
+
+#include "micro.h"
+#include "debug.h"
+#include "gpio.h"
+#include "jobs.h"
+#include "work_queue.h"
+
+// +--------------------------------------------------------------+
+// |                     Private Definitions                      |
+// +--------------------------------------------------------------+
+#define LOGIC_BUFFER_MASK      (LOGIC_BUFFER_SIZE-1)
+#define LOGIC_NS_PER_COUNT     (1000000000 / MICRO_PERF_BUS3_FREQ) //VCD timescale, one PBCLK3 period
+#define LOGIC_VCD_LINE_SIZE    128 //chars, enough for the time and every pin of one run
+#define LOGIC_MAX_RUN_SAMPLES  0xFFFF
+
+#if ((LOGIC_BUFFER_SIZE & LOGIC_BUFFER_MASK) != 0)
+#error LOGIC_BUFFER_SIZE must be a power of 2
+#endif
+#if ((1000000000 % MICRO_PERF_BUS3_FREQ) != 0)
+#error PBCLK3 period is not a whole number of nanoseconds
+#endif
+
+typedef enum
+{
+	LogicStopReason_Stopped    = 0x00,
+	LogicStopReason_MaxSamples = 0x01,
+	LogicStopReason_Overflow   = 0x02,
+} LogicStopReason_t;
+
+// +--------------------------------------------------------------+
+// |                       Private Globals                        |
+// +--------------------------------------------------------------+
+static const u16 timerPrescalers[] = { 1, 2, 4, 8, 16, 32, 64, 256 }; //index is the TCKPS value
+
+static LogicRun_t Runs[LOGIC_BUFFER_SIZE];
+static volatile u32 runsHead = 0; //written by the ISR
+static volatile u32 runsTail = 0; //written by LogicVcdJob
+
+static GpioPort_t capturePort = GpioPort_B;
+static volatile unsigned int* capturePortReg = nullptr;
+static u16 captureMask = 0;
+static u32 countsPerSample = 0; //PBCLK3 counts
+static LogicTrigger_t triggerType = LogicTrigger_None;
+static u16 triggerMask = 0;
+static u16 triggerValue = 0;
+
+static volatile bool running = false;
+static volatile bool triggered = false;
+static volatile u32 samplesRemaining = 0; //0 means no limit
+static volatile u32 numSamplesCaptured = 0;
+static volatile u32 numOverflows = 0;
+static u16 lastPortValue = 0;
+static u16 runValue = 0;
+static u32 runLength = 0;
+
+static bool vcdUploading = false;
+static bool stopReportPending = false; //the capture ended during an upload, LogicVcdJob reports it after "VCD END"
+static LogicStopReason_t pendingStopReason = LogicStopReason_Stopped;
+static bool vcdHeaderSent = false;
+static u64 vcdTime = 0; //in samples
+static u16 vcdLastValue = 0;
+
+// +--------------------------------------------------------------+
+// |                      Private Functions                       |
+// +--------------------------------------------------------------+
+static void LogicReportStop(u32 reason)
+{
+	//Anything we print now would land in the middle of the raw VCD text
+	if (vcdUploading) { pendingStopReason = (LogicStopReason_t)reason; stopReportPending = true; return; }
+	if (reason == LogicStopReason_Overflow) { PrintLine_W("Logic capture stopped, buffer full after %u samples", numSamplesCaptured); }
+	else { PrintLine_I("Logic capture finished, %u samples", numSamplesCaptured); }
+}
+
+//NOTE: Returns false when the ring is full
+static bool LogicPushRun()
+{
+	if (runLength == 0) { return true; }
+	u32 nextHead = (runsHead + 1) & LOGIC_BUFFER_MASK;
+	if (nextHead == runsTail) { numOverflows++; return false; }
+	Runs[runsHead].value = runValue;
+	Runs[runsHead].numSamples = (u16)runLength;
+	runsHead = nextHead;
+	runLength = 0;
+	return true;
+}
+
+//NOTE: Called from the ISR or with the Timer6 interrupt turned off
+static void LogicFinish(LogicStopReason_t reason)
+{
+	T6CONCLR = _T6CON_ON_MASK;
+	IEC0CLR = _IEC0_T6IE_MASK;
+	IFS0CLR = _IFS0_T6IF_MASK;
+	if (!running) { return; }
+	if (reason != LogicStopReason_Overflow && !LogicPushRun()) { reason = LogicStopReason_Overflow; }
+	running = false;
+	if (reason != LogicStopReason_Stopped) { WorkQueuePost(LogicReportStop, reason); }
+}
+
+static char LogicVcdId(u32 bit)
+{
+	return (char)('!' + bit);
+}
+
+static void LogicVcdPrint(const char* formatStr, ...)
+{
+	char lineBuffer[LOGIC_VCD_LINE_SIZE];
+	va_list args;
+	va_start(args, formatStr);
+	i32 length = vsnprintf(lineBuffer, sizeof(lineBuffer), formatStr, args);
+	va_end(args);
+	if (length <= 0) { return; }
+	if (length >= sizeof(lineBuffer)) { length = sizeof(lineBuffer)-1; }
+	DebugUartTxPutBytes((const u8*)lineBuffer, (u32)length);
+}
+
+static JobResult_t LogicVcdJob(Job_t* job)
+{
+	if (job->killRequested)
+	{
+		if (vcdHeaderSent) { LogicVcdPrint("\nVCD END (killed)\n"); DebugUartReleaseOutput(); }
+		else { WriteLine_W("VCD END (killed)"); }
+		vcdUploading = false;
+		if (stopReportPending) { stopReportPending = false; LogicReportStop(pendingStopReason); }
+		return JobResult_Done;
+	}
+	
+	if (!vcdHeaderSent)
+	{
+		if (DebugUartTxSpace() < LOGIC_VCD_LINE_SIZE * 4) { return JobResult_InProgress; }
+		//Waits for a binary dump (or the text it held back) to finish before starting
+		if (!DebugUartHoldOutput()) { return JobResult_InProgress; }
+		LogicVcdPrint("VCD BEGIN\n");
+		LogicVcdPrint("$timescale %u ns $end\n$scope module %s $end\n", LOGIC_NS_PER_COUNT, GpioPorts[capturePort].name);
+		u32 bit;
+		for (bit = 0; bit < 16; bit++)
+		{
+			if (IsFlagSet(captureMask, (1 << bit))) { LogicVcdPrint("$var wire 1 %c R%c%u $end\n", LogicVcdId(bit), GpioPorts[capturePort].name[4], bit); }
+		}
+		LogicVcdPrint("$upscope $end\n$enddefinitions $end\n");
+		vcdTime = 0;
+		vcdHeaderSent = true;
+	}
+	
+	while (runsTail != runsHead && DebugUartTxSpace() >= LOGIC_VCD_LINE_SIZE)
+	{
+		const LogicRun_t* run = &Runs[runsTail];
+		char lineBuffer[LOGIC_VCD_LINE_SIZE];
+		u32 lineLength = 0;
+		//Every run after the first starts with a change (or is a continuation of a run that was too long to fit in one entry)
+		u16 changedBits = (vcdTime == 0) ? captureMask : (u16)(run->value ^ vcdLastValue);
+		if (changedBits != 0)
+		{
+			lineLength += snprintf(&lineBuffer[lineLength], sizeof(lineBuffer) - lineLength, "#%llu\n", vcdTime * countsPerSample);
+			u32 bit;
+			for (bit = 0; bit < 16; bit++)
+			{
+				if (IsFlagSet(changedBits, (1 << bit)))
+				{
+					lineBuffer[lineLength++] = IsFlagSet(run->value, (1 << bit)) ? '1' : '0';
+					lineBuffer[lineLength++] = LogicVcdId(bit);
+					lineBuffer[lineLength++] = '\n';
+				}
+			}
+			DebugUartTxPutBytes((const u8*)lineBuffer, lineLength);
+		}
+		vcdLastValue = run->value;
+		vcdTime += run->numSamples;
+		runsTail = (runsTail + 1) & LOGIC_BUFFER_MASK;
+	}
+	
+	if (!running && runsTail == runsHead && DebugUartTxSpace() >= LOGIC_VCD_LINE_SIZE)
+	{
+		//Mark the end of the capture so the last value has a length
+		LogicVcdPrint("#%llu\nVCD END\n", vcdTime * countsPerSample);
+		DebugUartReleaseOutput();
+		vcdUploading = false;
+		if (stopReportPending) { stopReportPending = false; LogicReportStop(pendingStopReason); }
+		return JobResult_Done;
+	}
+	return JobResult_InProgress;
+}
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void LogicInit()
+{
+	ClearArray(Runs);
+	runsHead = 0;
+	runsTail = 0;
+	running = false;
+	triggerType = LogicTrigger_None;
+	
+	//+===============================+
+	//|         Timer6 Init           |
+	//+===============================+
+	T6CON = 0x0000;
+	T6CONbits.SIDL = 0; // Continue in idle mode.
+	IPC7bits.T6IP = 5; IPC7bits.T6IS = 0; //Int priority 5.0, below the waveform player so stimulus timing wins
+	IFS0bits.T6IF = CLEARED;
+	IEC0bits.T6IE = DISABLED;
+}
+
+void LogicSetTrigger(LogicTrigger_t type, u16 mask, u16 value)
+{
+	triggerType = type;
+	triggerMask = mask;
+	triggerValue = value & mask;
+}
+
+bool LogicStart(char portLetter, u16 mask, u32 rateHz, u32 maxSamples)
+{
+	GpioPort_t port = GpioPort_NumPorts;
+	u32 pIndex;
+	for (pIndex = 0; pIndex < GpioPort_NumPorts; pIndex++)
+	{
+		char letter = GpioPorts[pIndex].name[4]; //"PORTx"
+		if (portLetter == letter || portLetter == letter + ('a' - 'A')) { port = (GpioPort_t)pIndex; }
+	}
+	if (port == GpioPort_NumPorts) { PrintLine_E("There is no PORT%c", portLetter); return false; }
+	if (mask == 0) { WriteLine_E("No pins selected to capture"); return false; }
+	if (rateHz < LOGIC_MIN_RATE_HZ || rateHz > LOGIC_MAX_RATE_HZ) { PrintLine_E("Sample rate must be %u-%uHz", LOGIC_MIN_RATE_HZ, LOGIC_MAX_RATE_HZ); return false; }
+	if (vcdUploading) { WriteLine_E("Can't start a capture while the last one is being uploaded"); return false; }
+	LogicStop();
+	
+	//Use the smallest prescaler that fits the period in the 16-bit PR6 so the rate is as close as we can get
+	u32 numCounts = MICRO_PERF_BUS3_FREQ / rateHz;
+	u32 tckps = 0;
+	while (numCounts / timerPrescalers[tckps] > 0x10000) { tckps++; }
+	u32 periodCounts = numCounts / timerPrescalers[tckps];
+	
+	capturePort = port;
+	capturePortReg = GpioPorts[port].portReg;
+	captureMask = mask;
+	countsPerSample = periodCounts * timerPrescalers[tckps];
+	runsHead = 0;
+	runsTail = 0;
+	runLength = 0;
+	numSamplesCaptured = 0;
+	numOverflows = 0;
+	samplesRemaining = maxSamples;
+	lastPortValue = (u16)*capturePortReg;
+	triggered = (triggerType == LogicTrigger_None);
+	vcdHeaderSent = false;
+	running = true;
+	
+	T6CONbits.TCKPS = tckps;
+	TMR6 = 0;
+	PR6 = periodCounts - 1;
+	IFS0CLR = _IFS0_T6IF_MASK;
+	IEC0SET = _IEC0_T6IE_MASK;
+	T6CONbits.ON = ENABLED;
+	return true;
+}
+
+void LogicStop()
+{
+	IEC0CLR = _IEC0_T6IE_MASK;
+	LogicFinish(LogicStopReason_Stopped);
+}
+
+bool LogicIsRunning()
+{
+	return running;
+}
+
+void LogicPrintStatus()
+{
+	if (capturePortReg == nullptr) { WriteLine_I("No logic capture has been started"); return; }
+	
+	const char* stateStr = "Done";
+	if (running) { stateStr = triggered ? "Capturing" : "Waiting for trigger"; }
+	u32 rateHz = MICRO_PERF_BUS3_FREQ / countsPerSample;
+	PrintLine_I("%s: %s mask 0x%04X at %uHz (%uns per sample)", stateStr, GpioPorts[capturePort].name, captureMask, rateHz, countsPerSample * LOGIC_NS_PER_COUNT);
+	if (triggerType == LogicTrigger_Pattern) { PrintLine_I("Trigger: (%s & 0x%04X) == 0x%04X", GpioPorts[capturePort].name, triggerMask, triggerValue); }
+	else if (triggerType == LogicTrigger_Edge) { PrintLine_I("Trigger: any edge on %s mask 0x%04X", GpioPorts[capturePort].name, triggerMask); }
+	else { WriteLine_I("Trigger: none"); }
+	
+	u32 numRuns = (runsHead - runsTail) & LOGIC_BUFFER_MASK;
+	PrintLine_I("%u samples captured, %u/%u runs buffered, %u overflows", numSamplesCaptured, numRuns, LOGIC_BUFFER_SIZE-1, numOverflows);
+	if (numRuns > 0) { PrintLine_I("Compression: %u samples per run", numSamplesCaptured / numRuns); }
+}
+
+bool LogicStartVcdUpload()
+{
+	if (capturePortReg == nullptr) { WriteLine_E("Nothing has been captured"); return false; }
+	if (vcdUploading) { WriteLine_E("A VCD upload is already running"); return false; }
+	if (JobStart("vcd", LogicVcdJob) == nullptr) { return false; }
+	vcdHeaderSent = false;
+	vcdUploading = true;
+	stopReportPending = false;
+	return true;
+}
+
+// +--------------------------------------------------------------+
+// |                         Timer6 ISR                           |
+// +--------------------------------------------------------------+
+void __ISR(_TIMER_6_VECTOR, ipl5AUTO) LogicSampleIsr()
+{
+	u16 portValue = (u16)*capturePortReg;
+	IFS0CLR = _IFS0_T6IF_MASK;
+	
+	if (!triggered)
+	{
+		if (triggerType == LogicTrigger_Pattern) { triggered = ((portValue & triggerMask) == triggerValue); }
+		else { triggered = (((portValue ^ lastPortValue) & triggerMask) != 0); }
+		lastPortValue = portValue;
+		if (!triggered) { return; }
+	}
+	
+	u16 sample = portValue & captureMask;
+	if (runLength > 0 && (sample != runValue || runLength >= LOGIC_MAX_RUN_SAMPLES))
+	{
+		if (!LogicPushRun()) { LogicFinish(LogicStopReason_Overflow); return; }
+	}
+	runValue = sample;
+	runLength++;
+	numSamplesCaptured++;
+	
+	if (samplesRemaining > 0)
+	{
+		samplesRemaining--;
+		if (samplesRemaining == 0) { LogicFinish(LogicStopReason_MaxSamples); }
+	}
+}
@@ -4,7 +4,7 @@ Author: Taylor Robbins
 Date:   08\29\2019
 Description: 
 	** Holds the main entry point for the program which contains the main loop for the project.
-	** It also calls all of the initialization functions
+	** It also calls all of the initialization functions and registers each module's update function with the scheduler
 */
 
 #include "app.h"
@@ -12,6 +12,19 @@ Description:
 #include "micro.h"
 #include "debug.h"
 #include "tick_timer.h"
+#include "jobs.h"
+#include "soft_timers.h"
+#include "scheduler.h"
+#include "work_queue.h"
+#include "inputs.h"
+#include "debounce.h"
+#include "edge_log.h"
+#include "waveform.h"
+#include "logic_analyzer.h"
+#include "bench.h"
+#include "soft_pwm.h"
+#include "oc_pwm.h"
+#include "input_capture.h"
 
 // +--------------------------------------------------------------+
 // |                       Main Entry Point                       |
@@ -24,19 +37,44 @@ int main(void)
 	u8 resetCauses = MicroDetectResetCause();
 	MicroDisableInterrupts();
 	MicroInit();
+	DebounceInit();
 	TickTimerInit();
+	SoftTimersInit();
 	DebugUartInit();
+	JobsInit();
+	SchedulerInit();
+	WorkQueueInit();
+	EdgeLogInit();
+	InputsInit();
+	WaveformInit();
+	LogicInit();
+	BenchInit();
+	SoftPwmInit();
+	OcPwmInit();
+	CaptureInit();
 	MicroEnableInterrupts();
 	
 	AppInitialize();
 	
+	// +==============================+
+	// |            Tasks             |
+	// +==============================+
+	//NOTE: Tasks with a period of 0 are background tasks that share whatever time is left over
+	//               Name        Function          Period                  Deadline                  Priority
+	SchedulerAddTask("debounce", DebounceSample,   DEBOUNCE_SAMPLE_PERIOD, DEBOUNCE_SAMPLE_DEADLINE, 1);
+	SchedulerAddTask("timers",   SoftTimersUpdate, 0,                      0,                        0);
+	SchedulerAddTask("workq",    WorkQueueUpdate,  0,                      0,                        0);
+	SchedulerAddTask("inputs",   InputsUpdate,     0,                      0,                        0);
+	SchedulerAddTask("debug",    DebugUartUpdate,  0,                      0,                        0);
+	SchedulerAddTask("app",      AppUpdate,        0,                      0,                        0);
+	SchedulerAddTask("jobs",     JobsUpdate,       0,                      0,                        0);
+	
 	// +==============================+
 	// |          Main Loop           |
 	// +==============================+
 	while (FOREVER)
 	{
-		AppUpdate();
-		DebugUartUpdate();
+		SchedulerUpdate();
 	}
 	
 	// Should never get here.
@@ -11,6 +11,7 @@ Description:
 
 #include "app.h"
 #include "micro.h"
+#include "gpio.h"
 
 // +--------------------------------------------------------------+
 // |                        Public Globals                        |
@@ -31,13 +32,13 @@ void MicroInit()
 	// +==============================+
 	{
 		// All N/C pins are configured to analog inputs
-		ANSELA = 0b1100011011111111; //RA0, RA1, RA2, RA3, RA4, RA5, RA6, RA7, RA9, RA10, RA14, RA15
-		ANSELB = 0b1000111111111100; //RB2, RB3, RB4, RB5, RB6, RB7, RB8, RB9, RB10, RB11, RB15
+		ANSELA = 0b1000011011111111; //RA0, RA1, RA2, RA3, RA4, RA5, RA6, RA7, RA9, RA10, RA15
+		ANSELB = 0b1000111111110100; //RB2, RB4, RB5, RB6, RB7, RB8, RB9, RB10, RB11, RB15
 		ANSELC = 0b1111000000011110; //RC1, RC2, RC3, RC4, RC12, RC13, RC14, RC15
-		ANSELD = 0b1111111011111111; //RD0, RD1, RD2, RD3, RD4, RD5, RD6, RD7, RD9, RD10, RD11, RD12, RD13, RD14, RD15
+		ANSELD = 0b1111101011111100; //RD2, RD3, RD4, RD5, RD6, RD7, RD9, RD11, RD12, RD13, RD14, RD15
 		ANSELE = 0b0000001111111111; //RE0, RE1, RE2, RE3, RE4, RE5, RE6, RE7, RE8, RE9
-		ANSELF = 0b0011000100001111; //RF0, RF1, RF2, RF3, RF8, RF12, RF13
-		ANSELG = 0b1111001111000011; //RG0, RG1, RG6, RG7, RG8, RG9, RG12, RG13, RG14, RG15
+		ANSELF = 0b0011000100001011; //RF0, RF1, RF3, RF8, RF12, RF13
+		ANSELG = 0b1111001110000011; //RG0, RG1, RG7, RG8, RG9, RG12, RG13, RG14, RG15
 		ANSELH = 0b1111111111111000; //RH3, RH4, RH5, RH6, RH7, RH8, RH9, RH10, RH11, RH12, RH13, RH14, RH15
 		ANSELJ = 0b1111111111111111; //RJ0, RJ1, RJ2, RJ3, RJ4, RJ5, RJ6, RJ7, RJ8, RJ9, RJ10, RJ11, RJ12, RJ13, RJ14, RJ15
 		// ANSELK = 0b0000000010000001; //no ANSELK register I guess
@@ -53,7 +54,7 @@ void MicroInit()
 			(INPUT  << _TRISA_TRISA7_POSITION)  | // N/C
 			(INPUT  << _TRISA_TRISA9_POSITION)  | // N/C
 			(INPUT  << _TRISA_TRISA10_POSITION) | // N/C
-			(INPUT  << _TRISA_TRISA14_POSITION) | // N/C
+			(INPUT  << _TRISA_TRISA14_POSITION) | // @IC3 Capture (header pin 7)
 			(INPUT  << _TRISA_TRISA15_POSITION)   // N/C
 		);
 		
@@ -61,7 +62,7 @@ void MicroInit()
 			(INPUT  << _TRISB_TRISB0_POSITION)  | // @ICSP_CLOCK
 			(INPUT  << _TRISB_TRISB1_POSITION)  | // @ICSP_DATA
 			(INPUT  << _TRISB_TRISB2_POSITION)  | // N/C
-			(INPUT  << _TRISB_TRISB3_POSITION)  | // N/C
+			(OUTPUT << _TRISB_TRISB3_POSITION)  | // @OC4 PWM (header pin 15)
 			(INPUT  << _TRISB_TRISB4_POSITION)  | // N/C
 			(INPUT  << _TRISB_TRISB5_POSITION)  | // N/C
 			(INPUT  << _TRISB_TRISB6_POSITION)  | // N/C
@@ -72,7 +73,7 @@ void MicroInit()
 			(INPUT  << _TRISB_TRISB11_POSITION) | // N/C
 			(INPUT  << _TRISB_TRISB12_POSITION) | // @TEST_BTN1 (SW1)
 			(INPUT  << _TRISB_TRISB13_POSITION) | // @TEST_BTN2 (SW2)
-			(INPUT  << _TRISB_TRISB14_POSITION) | // @TEST_BTN3 (SW3)
+			(INPUT  << _TRISB_TRISB14_POSITION) | // @TEST_BTN3 (SW3), also IC6 Capture (header pin 10)
 			(INPUT  << _TRISB_TRISB15_POSITION)   // N/C
 		);
 		
@@ -88,8 +89,8 @@ void MicroInit()
 		);
 		
 		TRISD = (
-			(INPUT  << _TRISD_TRISD0_POSITION)  | // N/C
-			(INPUT  << _TRISD_TRISD1_POSITION)  | // N/C
+			(OUTPUT << _TRISD_TRISD0_POSITION)  | // @OC1 PWM (header pin 11)
+			(INPUT  << _TRISD_TRISD1_POSITION)  | // @IC1 Capture (header pin 23)
 			(INPUT  << _TRISD_TRISD2_POSITION)  | // N/C
 			(INPUT  << _TRISD_TRISD3_POSITION)  | // N/C
 			(INPUT  << _TRISD_TRISD4_POSITION)  | // N/C
@@ -97,7 +98,7 @@ void MicroInit()
 			(INPUT  << _TRISD_TRISD6_POSITION)  | // N/C
 			(INPUT  << _TRISD_TRISD7_POSITION)  | // N/C
 			(INPUT  << _TRISD_TRISD9_POSITION)  | // N/C
-			(INPUT  << _TRISD_TRISD10_POSITION) | // N/C
+			(OUTPUT << _TRISD_TRISD10_POSITION) | // @OC3 PWM (header pin 37)
 			(INPUT  << _TRISD_TRISD11_POSITION) | // N/C
 			(INPUT  << _TRISD_TRISD12_POSITION) | // N/C
 			(INPUT  << _TRISD_TRISD13_POSITION) | // N/C
@@ -121,7 +122,7 @@ void MicroInit()
 		TRISF = (
 			(INPUT  << _TRISF_TRISF0_POSITION)  | // N/C
 			(INPUT  << _TRISF_TRISF1_POSITION)  | // N/C
-			(INPUT  << _TRISF_TRISF2_POSITION)  | // N/C
+			(OUTPUT << _TRISF_TRISF2_POSITION)  | // @OC2 PWM (header pin 12)
 			(INPUT  << _TRISF_TRISF3_POSITION)  | // N/C
 			(INPUT  << _TRISF_TRISF4_POSITION)  | // @DEBUG_UART_RX (U5RX)
 			(OUTPUT << _TRISF_TRISF5_POSITION)  | // @DEBUG_UART_TX (U5TX)
@@ -133,7 +134,7 @@ void MicroInit()
 		TRISG = (
 			(INPUT  << _TRISG_TRISG0_POSITION)  | // N/C
 			(INPUT  << _TRISG_TRISG1_POSITION)  | // N/C
-			(INPUT  << _TRISG_TRISG6_POSITION)  | // N/C
+			(INPUT  << _TRISG_TRISG6_POSITION)  | // @IC2 Capture (header pin 8)
 			(INPUT  << _TRISG_TRISG7_POSITION)  | // N/C
 			(INPUT  << _TRISG_TRISG8_POSITION)  | // N/C
 			(INPUT  << _TRISG_TRISG9_POSITION)  | // N/C
@@ -192,20 +193,16 @@ void MicroInit()
 			(INPUT  << _TRISK_TRISK7_POSITION)    // N/C
 		);
 		
-		TEST_LED1_VALUE = HIGH;
-		TEST_LED2_VALUE = HIGH;
-		TEST_LED3_VALUE = HIGH;
+		GpioPortSet(GpioPortOf(TestLed1), GpioMask(TestLed1) | GpioMask(TestLed2) | GpioMask(TestLed3));
 		
 		TEST_BTN1_PULLUP = ENABLED;
 		TEST_BTN2_PULLUP = ENABLED;
 		TEST_BTN3_PULLUP = ENABLED;
 		
-		TEST_PIN1_VALUE = LOW;
-		TEST_PIN2_VALUE = LOW;
-		TEST_PIN3_VALUE = LOW;
-		TEST_PIN4_VALUE = LOW;
-		TEST_PIN5_VALUE = LOW;
-		TEST_PIN6_VALUE = LOW;
+		GpioPortClear(GpioPortOf(TestPin1),
+			GpioMask(TestPin1) | GpioMask(TestPin2) | GpioMask(TestPin3) |
+			GpioMask(TestPin4) | GpioMask(TestPin5) | GpioMask(TestPin6)
+		);
 	}
 	
 	// +==============================+
@@ -215,6 +212,18 @@ void MicroInit()
 		//UART5 Remap
 		U5RXRbits.U5RXR = 0b0010; // U5RX mapped to RF4
 		RPF5Rbits.RPF5R = 0b0011; // RF5 mapped to U5TX
+		
+		//Output Compare Remap (see oc_pwm.c)
+		RPD0Rbits.RPD0R   = 0b1100; // RD0 mapped to OC1
+		RPF2Rbits.RPF2R   = 0b1011; // RF2 mapped to OC2
+		RPD10Rbits.RPD10R = 0b1011; // RD10 mapped to OC3
+		RPB3Rbits.RPB3R   = 0b1011; // RB3 mapped to OC4
+		
+		//Input Capture Remap (see input_capture.c)
+		IC1Rbits.IC1R = 0b0000; // IC1 mapped to RD1
+		IC2Rbits.IC2R = 0b0001; // IC2 mapped to RG6
+		IC3Rbits.IC3R = 0b1101; // IC3 mapped to RA14
+		IC6Rbits.IC6R = 0b0010; // IC6 mapped to RB14
 	}
 	
 	// Enable Multi-Vector Interrupt Mode
@@ -236,10 +245,32 @@ u8 MicroDetectResetCause()
 	return result;
 }
 
+//NOTE: CP0 Count is never reset since TimeNowCycles depends on it running freely. Unsigned deltas handle it wrapping
+//      These all block everything except interrupts. Main loop code should use SchedulerRunAfter instead
+void MicroDelayCycles(u32 numCycles)
+{
+	u32 startCount = _CP0_GET_COUNT();
+	while ((_CP0_GET_COUNT() - startCount) < numCycles) { }
+}
+
+void MicroDelayUs(u32 delayUs)
+{
+	//Split long delays up so delayUs * MICRO_ONE_US_COUNT can't overflow
+	while (delayUs > 1000000)
+	{
+		MicroDelayCycles(1000000 * MICRO_ONE_US_COUNT);
+		delayUs -= 1000000;
+	}
+	MicroDelayCycles(delayUs * MICRO_ONE_US_COUNT);
+}
+
 void MicroDelay(u32 delayMs)
 {
-	_CP0_SET_COUNT(0);
-	while (_CP0_GET_COUNT() < delayMs*MICRO_ONE_MS_COUNT) { Nop(); }
+	while (delayMs > 0)
+	{
+		MicroDelayCycles(MICRO_ONE_MS_COUNT);
+		delayMs--;
+	}
 }
 
 void MicroReset()
@@ -251,6 +282,43 @@ void MicroReset()
 	while(FOREVER) { Nop(); } // Prevent any unwanted code execution until reset occurs.
 }
 
+#if (MICRO_RAM_PHYS_START != 0)
+#error MicroIsValidMemoryRange assumes RAM starts at physical address 0
+#endif
+
+//Checks that the range lies entirely inside RAM, flash or SFR space and is accessed through KSEG0 or KSEG1
+//Flash can only be read and SFRs can only be reached through KSEG1
+bool MicroIsValidMemoryRange(u32 address, u32 length, bool forWriting)
+{
+	if (length == 0) { return false; }
+	if (!IS_KVA01(address) || !IS_KVA01(address + length - 1)) { return false; }
+	if (address + length - 1 < address) { return false; } //wraps around
+	if (((address ^ (address + length - 1)) & 0xE0000000) != 0) { return false; } //crosses from KSEG0 into KSEG1
+	
+	u32 physStart = KVA_TO_PA(address);
+	u32 physEnd   = KVA_TO_PA(address + length - 1);
+	if (physEnd < MICRO_RAM_SIZE)
+	{
+		return true;
+	}
+	if (physStart >= MICRO_SFR_PHYS_START && physEnd < MICRO_SFR_PHYS_START + MICRO_SFR_SIZE)
+	{
+		return IS_KVA1(address);
+	}
+	if (!forWriting)
+	{
+		if (physStart >= MICRO_FLASH_PHYS_START && physEnd < MICRO_FLASH_PHYS_START + MICRO_FLASH_SIZE) { return true; }
+		if (physStart >= MICRO_BOOT_FLASH_PHYS_START && physEnd < MICRO_BOOT_FLASH_PHYS_START + MICRO_BOOT_FLASH_SIZE) { return true; }
+	}
+	return false;
+}
+
+bool MicroIsSfrAddress(u32 address)
+{
+	u32 physAddress = KVA_TO_PA(address);
+	return (physAddress >= MICRO_SFR_PHYS_START && physAddress < MICRO_SFR_PHYS_START + MICRO_SFR_SIZE);
+}
+
 // +--------------------------------------------------------------+
 // |       Default Interrupt and General Exception Handler        |
 // +--------------------------------------------------------------+
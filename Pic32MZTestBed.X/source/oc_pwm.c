@@ -0,0 +1,200 @@
+/*
+File:   oc_pwm.c
+Author: Taylor Robbins
+Date:   10\19\2026
+Description:
+	** Drives the header pins in OC_PWM_CHANNELS with the output compare modules running in PWM mode, so unlike
+	** soft_pwm.c the CPU does nothing once a duty cycle is set (no interrupts at all). Every channel shares Timer2 as
+	** its timebase (OCTSEL = 0) so they all run at the same frequency with their rising edges lined up.
+	
+	** In PWM mode the module copies OCxRS into OCxR when Timer2 rolls over, so a new duty cycle is a single store to
+	** OCxRS and always takes effect at the start of the next period. There's never a runt or stretched pulse.
+	** Changing the frequency has to stop Timer2 to change the prescaler, so it cuts the current period short.
+	
+	** The pins are mapped to the modules in MicroInit's Peripheral Pin Mapping block
+*/
+
+#include "app.h"
+#include "oc_pwm.h"
+
+#include "micro.h"
+#include "debug.h"
+
+// +--------------------------------------------------------------+
+// |                     Private Definitions                      |
+// +--------------------------------------------------------------+
+#define OC_PWM_OCM_PWM            0b110 //PWM mode, fault pin disabled
+#define OC_PWM_MAX_PERIOD_COUNTS  0xFFFF //OCxRS has to be able to go one past PR2 for a duty of 100%
+
+typedef struct
+{
+	const char* name;
+	const char* pinName;
+	u8 headerPin;
+	volatile unsigned int* conReg;
+	volatile unsigned int* conClrReg;
+	volatile unsigned int* conSetReg;
+	volatile unsigned int* rReg;
+	volatile unsigned int* rsReg;
+} OcPwmModule_t;
+
+// +--------------------------------------------------------------+
+// |                       Private Globals                        |
+// +--------------------------------------------------------------+
+static const u16 timerPrescalers[] = { 1, 2, 4, 8, 16, 32, 64, 256 }; //index is the TCKPS value
+
+#define OC_PWM_MODULE_ENTRY(name, module, pinName, headerPin) { "OC" #module, pinName, headerPin, &OC##module##CON, &OC##module##CONCLR, &OC##module##CONSET, &OC##module##R, &OC##module##RS },
+static const OcPwmModule_t Modules[OcPwm_NumChannels] = { OC_PWM_CHANNELS(OC_PWM_MODULE_ENTRY) };
+
+static u32 pwmFrequency = 0; //what the user asked for
+static u32 periodCounts = 0; //Timer2 counts per period (PR2 + 1)
+static u32 timerPrescaler = 1;
+static bool channelEnabled[OcPwm_NumChannels];
+static u16 channelDuty[OcPwm_NumChannels];
+
+// +--------------------------------------------------------------+
+// |                      Private Functions                       |
+// +--------------------------------------------------------------+
+static u32 OcPwmDutyToCounts(u16 duty)
+{
+	return (periodCounts * duty) / OC_PWM_MAX_DUTY;
+}
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void OcPwmInit()
+{
+	ClearArray(channelEnabled);
+	ClearArray(channelDuty);
+	
+	u32 cIndex;
+	for (cIndex = 0; cIndex < OcPwm_NumChannels; cIndex++)
+	{
+		*Modules[cIndex].conReg = 0x0000; //Off until a duty cycle is given. The pin reads low while the module is off
+	}
+	
+	//+===============================+
+	//|         Timer2 Init           |
+	//+===============================+
+	T2CON = 0x0000;
+	T2CONbits.SIDL = 0; // Continue in idle mode.
+	IFS0bits.T2IF = CLEARED;
+	IEC0bits.T2IE = DISABLED; //The output compare modules do all the work, Timer2 never interrupts
+	
+	OcPwmSetFrequency(OC_PWM_DEFAULT_FREQUENCY);
+}
+
+bool OcPwmSetFrequency(u32 frequency)
+{
+	if (frequency < OC_PWM_MIN_FREQUENCY || frequency > OC_PWM_MAX_FREQUENCY) { PrintLine_E("PWM frequency must be %u-%uHz", OC_PWM_MIN_FREQUENCY, OC_PWM_MAX_FREQUENCY); return false; }
+	
+	//Use the smallest prescaler that fits the period in the 16-bit PR2 so the duty cycle has the most resolution
+	u32 numCounts = MICRO_PERF_BUS3_FREQ / frequency;
+	u32 tckps = 0;
+	while (numCounts / timerPrescalers[tckps] > OC_PWM_MAX_PERIOD_COUNTS) { tckps++; }
+	
+	T2CONCLR = _T2CON_ON_MASK;
+	pwmFrequency = frequency;
+	timerPrescaler = timerPrescalers[tckps];
+	periodCounts = numCounts / timerPrescaler;
+	T2CONbits.TCKPS = tckps;
+	PR2 = periodCounts - 1;
+	
+	//Rescale every running channel so it keeps the same duty cycle at the new frequency
+	u32 cIndex;
+	for (cIndex = 0; cIndex < OcPwm_NumChannels; cIndex++)
+	{
+		if (!channelEnabled[cIndex]) { continue; }
+		u32 dutyCounts = OcPwmDutyToCounts(channelDuty[cIndex]);
+		*Modules[cIndex].rsReg = dutyCounts;
+		*Modules[cIndex].rReg = dutyCounts;
+	}
+	
+	TMR2 = 0;
+	T2CONSET = _T2CON_ON_MASK;
+	return true;
+}
+
+u32 OcPwmGetFrequency()
+{
+	return pwmFrequency;
+}
+
+void OcPwmSetDuty(OcPwmChannel_t channel, u16 duty)
+{
+	Assert(channel < OcPwm_NumChannels);
+	if (duty > OC_PWM_MAX_DUTY) { duty = OC_PWM_MAX_DUTY; }
+	const OcPwmModule_t* module = &Modules[channel];
+	u32 dutyCounts = OcPwmDutyToCounts(duty);
+	channelDuty[channel] = duty;
+	
+	if (channelEnabled[channel])
+	{
+		//Latched into OCxR by the hardware at the next Timer2 rollover
+		*module->rsReg = dutyCounts;
+	}
+	else
+	{
+		*module->rReg = dutyCounts;
+		*module->rsReg = dutyCounts;
+		*module->conReg = (OC_PWM_OCM_PWM << _OC1CON_OCM_POSITION); //OCTSEL = 0 (Timer2), 16-bit compare
+		*module->conSetReg = _OC1CON_ON_MASK;
+		channelEnabled[channel] = true;
+	}
+}
+
+//NOTE: The pin goes low right away, even part way through a pulse
+void OcPwmRelease(OcPwmChannel_t channel)
+{
+	Assert(channel < OcPwm_NumChannels);
+	*Modules[channel].conClrReg = _OC1CON_ON_MASK;
+	channelEnabled[channel] = false;
+}
+
+bool OcPwmIsEnabled(OcPwmChannel_t channel)
+{
+	Assert(channel < OcPwm_NumChannels);
+	return channelEnabled[channel];
+}
+
+u16 OcPwmGetDuty(OcPwmChannel_t channel)
+{
+	Assert(channel < OcPwm_NumChannels);
+	return channelDuty[channel];
+}
+
+//NOTE: Accepts either the module name (ex. OC1) or the pin it's mapped to (ex. RD0)
+bool OcPwmFindByName(const char* name, u32 nameLength, OcPwmChannel_t* channelOut)
+{
+	u32 cIndex;
+	for (cIndex = 0; cIndex < OcPwm_NumChannels; cIndex++)
+	{
+		const OcPwmModule_t* module = &Modules[cIndex];
+		if ((strlen(module->name) == nameLength && strncmp(module->name, name, nameLength) == 0) ||
+			(strlen(module->pinName) == nameLength && strncmp(module->pinName, name, nameLength) == 0))
+		{
+			if (channelOut != nullptr) { *channelOut = (OcPwmChannel_t)cIndex; }
+			return true;
+		}
+	}
+	return false;
+}
+
+void OcPwmPrintChannels()
+{
+	u32 actualFrequency = MICRO_PERF_BUS3_FREQ / timerPrescaler / periodCounts;
+	PrintLine_I("Output compare PWM at %uHz (actual %uHz), Timer2 1:%u, %u counts per period", pwmFrequency, actualFrequency, timerPrescaler, periodCounts);
+	u32 cIndex;
+	for (cIndex = 0; cIndex < OcPwm_NumChannels; cIndex++)
+	{
+		const OcPwmModule_t* module = &Modules[cIndex];
+		if (channelEnabled[cIndex])
+		{
+			PrintLine_I("  %s %-4s (header pin %2u) %3u.%u%% (%u/%u counts)", module->name, module->pinName, module->headerPin,
+				channelDuty[cIndex] / 10, channelDuty[cIndex] % 10, OcPwmDutyToCounts(channelDuty[cIndex]), periodCounts
+			);
+		}
+		else { PrintLine_I("  %s %-4s (header pin %2u) off", module->name, module->pinName, module->headerPin); }
+	}
+}
@@ -0,0 +1,340 @@
+/*
+File:   scheduler.c
+Author: Taylor Robbins
+Date:   10\19\2026
+Description:
+	** Holds a small cooperative scheduler that decides which module's update function the main loop runs next
+	** Periodic tasks are released every periodMs and have to start before their deadline. Whenever one or more of them
+	** are ready we run the one with the earliest deadline (priority breaks ties). When none are ready we run the next
+	** background task (periodMs = 0) in round-robin order, so background work can never starve a periodic task by more
+	** than the length of one background task.
+	
+	** SchedulerRunAfter is the non-blocking replacement for MicroDelay in main loop code. It calls a function once after
+	** a delay, ahead of any periodic task, without holding up everything else in the meantime.
+	
+	** Each task keeps track of how many times it ran, how long it took (in CP0 Count cycles) and how many
+	** times it started after its deadline. The "tasks" command prints these.
+	
+	** If SCHEDULER_IDLE_WAIT_ENABLED is true then once every background task has had a turn, and nothing asked to stay
+	** awake, we put the core to sleep with the WAIT instruction until the next interrupt. ISRs that create work for the
+	** main loop (tick, debug Rx, button change notification) call SchedulerWake so that an interrupt that lands while
+	** we are part way through a round still gets a full round after it. Background tasks that still have work to do
+	** (like running jobs) call SchedulerStayAwake. The time spent in WAIT gives us the idle percentage shown in "status"
+*/
+
+#include "app.h"
+#include "scheduler.h"
+
+#include "micro.h"
+#include "debug.h"
+#include "tick_timer.h"
+#include "soft_timers.h"
+
+// +--------------------------------------------------------------+
+// |                   Private Structures/Types                   |
+// +--------------------------------------------------------------+
+typedef struct
+{
+	bool active;
+	TaskFunc_f function;
+	u32 dueTimeMs;
+} DelayedCall_t;
+
+// +--------------------------------------------------------------+
+// |                       Private Globals                        |
+// +--------------------------------------------------------------+
+static Task_t Tasks[MAX_NUM_TASKS];
+static DelayedCall_t DelayedCalls[SCHEDULER_MAX_DELAYED_CALLS];
+static u32 nextBackgroundIndex = 0;
+static u32 numBackgroundTasks = 0;
+static u32 backgroundRunsThisRound = 0;
+static SoftTimer_t wakeTimer;
+
+static volatile bool wakeRequested = false;
+static bool stayAwake = false;
+static u32 idleCycles = 0;
+static u32 idleWindowStartCount = 0;
+static u32 idlePermille = 0;
+
+// +--------------------------------------------------------------+
+// |                      Private Functions                       |
+// +--------------------------------------------------------------+
+static u32 TaskGetDeadline(const Task_t* task)
+{
+	return task->releaseTimeMs + ((task->deadlineMs > 0) ? task->deadlineMs : task->periodMs);
+}
+
+//The WAIT in SchedulerIdle relies on the tick interrupt to wake us up in time for periodic releases and delayed calls.
+//In tickless mode the tick only comes when a soft timer is due, so we keep wakeTimer running until the earliest one
+static void SchedulerArmWakeTimer()
+{
+	bool anythingDue = false;
+	u32 nextDueMs = 0;
+	u32 tIndex;
+	for (tIndex = 0; tIndex < MAX_NUM_TASKS; tIndex++)
+	{
+		const Task_t* task = &Tasks[tIndex];
+		if (!task->active || task->periodMs == 0) { continue; }
+		if (!anythingDue || TimeIsBefore(task->releaseTimeMs, nextDueMs)) { nextDueMs = task->releaseTimeMs; anythingDue = true; }
+	}
+	u32 cIndex;
+	for (cIndex = 0; cIndex < SCHEDULER_MAX_DELAYED_CALLS; cIndex++)
+	{
+		const DelayedCall_t* call = &DelayedCalls[cIndex];
+		if (!call->active) { continue; }
+		if (!anythingDue || TimeIsBefore(call->dueTimeMs, nextDueMs)) { nextDueMs = call->dueTimeMs; anythingDue = true; }
+	}
+	
+	if (!anythingDue) { SoftTimerStop(&wakeTimer); return; }
+	i32 delayMs = (i32)(nextDueMs - TickTimerGetMs());
+	SoftTimerStart(&wakeTimer, (delayMs > 0) ? (u32)delayMs : 0, 0, nullptr, nullptr);
+}
+
+static void SchedulerRunTask(Task_t* task)
+{
+	u32 startCount = _CP0_GET_COUNT();
+	task->function();
+	u32 numCycles = _CP0_GET_COUNT() - startCount;
+	
+	task->numRuns++;
+	task->totalCycles += numCycles;
+	if (numCycles > task->maxCycles) { task->maxCycles = numCycles; }
+}
+
+//NOTE: Only called once no periodic task is ready and every background task has run since the last wake up
+static void SchedulerIdle()
+{
+	#if SCHEDULER_IDLE_WAIT_ENABLED
+	MicroDisableInterrupts();
+	if (!wakeRequested && !stayAwake)
+	{
+		//NOTE: A pending interrupt still ends the WAIT while interrupts are disabled, it just doesn't get serviced until the ei
+		u32 startCount = _CP0_GET_COUNT();
+		asm volatile("wait");
+		idleCycles += _CP0_GET_COUNT() - startCount;
+	}
+	MicroEnableInterrupts();
+	#endif
+	
+	//Any ISR that ran before this point will have its work handled by the next round
+	wakeRequested = false;
+	stayAwake = false;
+}
+
+static void SchedulerUpdateIdleStats()
+{
+	u32 windowCycles = _CP0_GET_COUNT() - idleWindowStartCount;
+	if (windowCycles >= SCHEDULER_IDLE_WINDOW_MS * MICRO_ONE_MS_COUNT)
+	{
+		idlePermille = (u32)(((u64)idleCycles * 1000) / windowCycles);
+		idleCycles = 0;
+		idleWindowStartCount += windowCycles;
+	}
+}
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void SchedulerInit()
+{
+	ClearArray(Tasks);
+	ClearArray(DelayedCalls);
+	ClearStruct(wakeTimer);
+	nextBackgroundIndex = 0;
+	numBackgroundTasks = 0;
+	backgroundRunsThisRound = 0;
+	idleCycles = 0;
+	idleWindowStartCount = _CP0_GET_COUNT();
+	idlePermille = 0;
+}
+
+Task_t* SchedulerAddTask(const char* name, TaskFunc_f function, u32 periodMs, u32 deadlineMs, u8 priority)
+{
+	Assert(function != nullptr);
+	Assert(deadlineMs <= periodMs || periodMs == 0);
+	
+	u32 tIndex;
+	for (tIndex = 0; tIndex < MAX_NUM_TASKS; tIndex++)
+	{
+		Task_t* task = &Tasks[tIndex];
+		if (!task->active)
+		{
+			ClearPointer(task);
+			task->active = true;
+			task->name = (name != nullptr) ? name : "task";
+			task->function = function;
+			task->periodMs = periodMs;
+			task->deadlineMs = deadlineMs;
+			task->priority = priority;
+			task->releaseTimeMs = TickTimerGetMs();
+			if (periodMs > 0) { SchedulerArmWakeTimer(); }
+			else { numBackgroundTasks++; }
+			return task;
+		}
+	}
+	
+	PrintLine_E("Can't add task \"%s\". All %u task slots are in use", (name != nullptr) ? name : "task", MAX_NUM_TASKS);
+	return nullptr;
+}
+
+bool SchedulerRunAfter(TaskFunc_f function, u32 delayMs)
+{
+	Assert(function != nullptr);
+	
+	u32 cIndex;
+	for (cIndex = 0; cIndex < SCHEDULER_MAX_DELAYED_CALLS; cIndex++)
+	{
+		DelayedCall_t* call = &DelayedCalls[cIndex];
+		if (!call->active)
+		{
+			call->active = true;
+			call->function = function;
+			call->dueTimeMs = TickTimerGetMs() + delayMs;
+			SchedulerArmWakeTimer();
+			return true;
+		}
+	}
+	
+	PrintLine_E("Can't delay call. All %u delayed call slots are in use", SCHEDULER_MAX_DELAYED_CALLS);
+	return false;
+}
+
+void SchedulerUpdate()
+{
+	SchedulerUpdateIdleStats();
+	u32 currentTimeMs = TickTimerGetMs();
+	
+	// +==============================+
+	// |        Delayed Calls         |
+	// +==============================+
+	u32 cIndex;
+	for (cIndex = 0; cIndex < SCHEDULER_MAX_DELAYED_CALLS; cIndex++)
+	{
+		DelayedCall_t* call = &DelayedCalls[cIndex];
+		if (call->active && TimeHasReached(currentTimeMs, call->dueTimeMs))
+		{
+			//NOTE: Free the slot first so the function is allowed to delay itself again
+			TaskFunc_f function = call->function;
+			call->active = false;
+			SchedulerArmWakeTimer();
+			function();
+			return;
+		}
+	}
+	
+	// +==============================+
+	// |  Earliest Deadline Periodic  |
+	// +==============================+
+	Task_t* nextTask = nullptr;
+	u32 nextDeadlineMs = 0;
+	u32 tIndex;
+	for (tIndex = 0; tIndex < MAX_NUM_TASKS; tIndex++)
+	{
+		Task_t* task = &Tasks[tIndex];
+		if (!task->active || task->periodMs == 0) { continue; }
+		if (!TimeHasReached(currentTimeMs, task->releaseTimeMs)) { continue; }
+		
+		u32 deadlineMs = TaskGetDeadline(task);
+		if (nextTask == nullptr || TimeIsBefore(deadlineMs, nextDeadlineMs) ||
+			(deadlineMs == nextDeadlineMs && task->priority > nextTask->priority))
+		{
+			nextTask = task;
+			nextDeadlineMs = deadlineMs;
+		}
+	}
+	
+	if (nextTask != nullptr)
+	{
+		if (TimeIsAfter(currentTimeMs, nextDeadlineMs))
+		{
+			u32 latenessMs = currentTimeMs - nextDeadlineMs;
+			nextTask->numOverruns++;
+			if (latenessMs > nextTask->maxLatenessMs) { nextTask->maxLatenessMs = latenessMs; }
+		}
+		
+		nextTask->releaseTimeMs += nextTask->periodMs;
+		//If we fell more than a whole period behind don't try to catch up by running back to back
+		if (TimeIsBefore(nextTask->releaseTimeMs + nextTask->periodMs, currentTimeMs)) { nextTask->releaseTimeMs = currentTimeMs; }
+		SchedulerArmWakeTimer();
+		
+		SchedulerRunTask(nextTask);
+		return;
+	}
+	
+	// +==============================+
+	// |   Round-Robin Background     |
+	// +==============================+
+	if (backgroundRunsThisRound >= numBackgroundTasks)
+	{
+		SchedulerIdle();
+		backgroundRunsThisRound = 0;
+		return;
+	}
+	for (tIndex = 0; tIndex < MAX_NUM_TASKS; tIndex++)
+	{
+		Task_t* task = &Tasks[nextBackgroundIndex];
+		nextBackgroundIndex = (nextBackgroundIndex + 1) % MAX_NUM_TASKS;
+		if (task->active && task->periodMs == 0)
+		{
+			SchedulerRunTask(task);
+			backgroundRunsThisRound++;
+			return;
+		}
+	}
+}
+
+void SchedulerResetStats()
+{
+	u32 tIndex;
+	for (tIndex = 0; tIndex < MAX_NUM_TASKS; tIndex++)
+	{
+		Task_t* task = &Tasks[tIndex];
+		task->numRuns = 0;
+		task->numOverruns = 0;
+		task->maxLatenessMs = 0;
+		task->totalCycles = 0;
+		task->maxCycles = 0;
+	}
+}
+
+void SchedulerPrintTasks()
+{
+	u32 tIndex;
+	for (tIndex = 0; tIndex < MAX_NUM_TASKS; tIndex++)
+	{
+		const Task_t* task = &Tasks[tIndex];
+		if (!task->active) { continue; }
+		
+		u32 averageUs = (task->numRuns > 0) ? (u32)(task->totalCycles / task->numRuns / TIME_CYCLES_PER_US) : 0;
+		if (task->periodMs > 0)
+		{
+			PrintLine_I("%-8s every %ums (deadline %ums, priority %u): %u runs, avg %uus, max %uus, %u overruns (max %ums late)",
+				task->name, task->periodMs, TaskGetDeadline(task) - task->releaseTimeMs, task->priority,
+				task->numRuns, averageUs, task->maxCycles / TIME_CYCLES_PER_US, task->numOverruns, task->maxLatenessMs
+			);
+		}
+		else
+		{
+			PrintLine_I("%-8s background: %u runs, avg %uus, max %uus",
+				task->name, task->numRuns, averageUs, task->maxCycles / TIME_CYCLES_PER_US
+			);
+		}
+	}
+}
+
+//NOTE: Safe to call from any ISR
+void SchedulerWake()
+{
+	wakeRequested = true;
+}
+
+//Called by background tasks that have more work to do and don't want the main loop to WAIT
+void SchedulerStayAwake()
+{
+	stayAwake = true;
+}
+
+u32 SchedulerGetIdlePermille()
+{
+	return idlePermille;
+}
@@ -0,0 +1,297 @@
+/*
+File:   soft_pwm.c
+Author: Taylor Robbins
+Date:   10\19\2026
+Description:
+	** Holds a software PWM that can give any pin in SOFT_PWM_CHANNELS a duty cycle, all from one Timer5 interrupt.
+	** Rather than interrupting at every step of the period we build a schedule: one event at the start of the period
+	** that sets every channel with a duty above 0, followed by one event per distinct duty cycle (sorted) that clears
+	** all the channels with that duty. Each event is a single store to LATxSET/LATxCLR per port, and Timer5's period is
+	** reloaded with the time until the next event, so the cost is (number of distinct duties + 1) interrupts per period.
+	
+	** Schedules are built in the main loop when a duty cycle changes and handed to the ISR, which only switches to the
+	** new one at the start of a period, so a change never produces a runt or stretched pulse.
+	** When every channel is at 0 or SOFT_PWM_MAX_DUTY there is nothing to schedule, so we write the pins directly and
+	** turn Timer5 off. That way a channel that's just on or off doesn't keep the core out of WAIT or tickless mode.
+	** Channels that haven't been given a duty (or were released) are left alone so they can still be driven with gpio.h
+*/
+
+#include "app.h"
+#include "soft_pwm.h"
+
+#include "micro.h"
+#include "debug.h"
+#include "gpio.h"
+
+// +--------------------------------------------------------------+
+// |                     Private Definitions                      |
+// +--------------------------------------------------------------+
+#define SOFT_PWM_TIMER_PRESCALER   4
+#define SOFT_PWM_TIMER_TCKPS_VALUE 0b010 //1:4
+#define SOFT_PWM_PERIOD_COUNTS     (MICRO_PERF_BUS3_FREQ / SOFT_PWM_TIMER_PRESCALER / SOFT_PWM_FREQUENCY)
+#define SOFT_PWM_MIN_STEP_COUNTS   50 //2us, about the shortest gap between events the ISR can keep up with
+
+#if (SOFT_PWM_PERIOD_COUNTS > 0x10000)
+#error SOFT_PWM_FREQUENCY is too low for the 16-bit PR5 register with this prescaler
+#endif
+#if ((SOFT_PWM_PERIOD_COUNTS / SOFT_PWM_MAX_DUTY) < SOFT_PWM_MIN_STEP_COUNTS)
+#error SOFT_PWM_FREQUENCY is too high, one duty step would be shorter than SOFT_PWM_MIN_STEP_COUNTS
+#endif
+
+#define SOFT_PWM_PIN_ENTRY(pinName) Gpio_##pinName,
+
+typedef struct
+{
+	u32 timeCounts; //since the start of the period
+	u32 setMasks[SOFT_PWM_MAX_PORTS];   //only used by the first event, for every channel with a duty above 0
+	u32 clearMasks[SOFT_PWM_MAX_PORTS]; //the first event also clears channels at 0 in case they were left high
+} SoftPwmEvent_t;
+
+typedef struct
+{
+	u32 numEvents;
+	SoftPwmEvent_t events[SoftPwm_NumChannels + 1];
+} SoftPwmSchedule_t;
+
+// +--------------------------------------------------------------+
+// |                       Private Globals                        |
+// +--------------------------------------------------------------+
+static const Gpio_t channelPins[SoftPwm_NumChannels] = { SOFT_PWM_CHANNELS(SOFT_PWM_PIN_ENTRY) };
+static u8 channelPortIndex[SoftPwm_NumChannels]; //index into pwmPorts
+static u8 channelDuty[SoftPwm_NumChannels];
+static bool channelEnabled[SoftPwm_NumChannels];
+
+static const GpioPortRegs_t* pwmPorts[SOFT_PWM_MAX_PORTS];
+static u32 numPwmPorts = 0;
+
+static SoftPwmSchedule_t Schedules[2];
+static volatile u32 activeScheduleIndex = 0;
+static volatile bool schedulePending = false;
+static u32 eventIndex = 0; //only used by the ISR
+static bool timerRunning = false;
+
+// +--------------------------------------------------------------+
+// |                      Private Functions                       |
+// +--------------------------------------------------------------+
+static void SoftPwmStartTimer()
+{
+	eventIndex = 0;
+	TMR5 = 0;
+	PR5 = SOFT_PWM_MIN_STEP_COUNTS - 1; //The first interrupt starts the first period
+	IFS0CLR = _IFS0_T5IF_MASK;
+	IEC0SET = _IEC0_T5IE_MASK;
+	T5CONbits.ON = ENABLED;
+	timerRunning = true;
+}
+
+static void SoftPwmStopTimer()
+{
+	IEC0CLR = _IEC0_T5IE_MASK;
+	T5CONbits.ON = DISABLED;
+	IFS0CLR = _IFS0_T5IF_MASK;
+	timerRunning = false;
+}
+
+//Called from the main loop whenever a channel changes. Builds the next schedule and tells the ISR to pick it up
+static void SoftPwmRebuild()
+{
+	//Stop the ISR from switching while we write, then write whichever schedule it isn't using
+	schedulePending = false;
+	SoftPwmSchedule_t* schedule = &Schedules[activeScheduleIndex ^ 1];
+	ClearPointer(schedule);
+	
+	//Sort the channels that need a falling edge by duty (insertion sort, there are only a handful)
+	u8 sortedChannels[SoftPwm_NumChannels];
+	u32 numSorted = 0;
+	u32 cIndex;
+	for (cIndex = 0; cIndex < SoftPwm_NumChannels; cIndex++)
+	{
+		if (!channelEnabled[cIndex]) { continue; }
+		u8 duty = channelDuty[cIndex];
+		u32 pinMask = GpioPins[channelPins[cIndex]].mask;
+		if (duty > 0) { schedule->events[0].setMasks[channelPortIndex[cIndex]] |= pinMask; }
+		else { schedule->events[0].clearMasks[channelPortIndex[cIndex]] |= pinMask; }
+		if (duty == 0 || duty == SOFT_PWM_MAX_DUTY) { continue; }
+		
+		u32 insertIndex = numSorted;
+		while (insertIndex > 0 && channelDuty[sortedChannels[insertIndex-1]] > duty)
+		{
+			sortedChannels[insertIndex] = sortedChannels[insertIndex-1];
+			insertIndex--;
+		}
+		sortedChannels[insertIndex] = (u8)cIndex;
+		numSorted++;
+	}
+	
+	//Channels with the same duty share one event
+	schedule->numEvents = 1;
+	u32 sIndex;
+	for (sIndex = 0; sIndex < numSorted; sIndex++)
+	{
+		u8 channel = sortedChannels[sIndex];
+		u32 timeCounts = ((u32)channelDuty[channel] * SOFT_PWM_PERIOD_COUNTS) / SOFT_PWM_MAX_DUTY;
+		SoftPwmEvent_t* event = &schedule->events[schedule->numEvents - 1];
+		if (schedule->numEvents == 1 || event->timeCounts != timeCounts)
+		{
+			event = &schedule->events[schedule->numEvents];
+			event->timeCounts = timeCounts;
+			schedule->numEvents++;
+		}
+		event->clearMasks[channelPortIndex[channel]] |= GpioPins[channelPins[channel]].mask;
+	}
+	
+	if (numSorted == 0)
+	{
+		//Only the first event has anything in it, so set the pins once here instead of every period in the ISR
+		SoftPwmStopTimer();
+		activeScheduleIndex ^= 1;
+		u32 pIndex;
+		for (pIndex = 0; pIndex < numPwmPorts; pIndex++)
+		{
+			if (schedule->events[0].setMasks[pIndex] != 0)   { *pwmPorts[pIndex]->latSetReg = schedule->events[0].setMasks[pIndex]; }
+			if (schedule->events[0].clearMasks[pIndex] != 0) { *pwmPorts[pIndex]->latClrReg = schedule->events[0].clearMasks[pIndex]; }
+		}
+	}
+	else
+	{
+		schedulePending = true;
+		if (!timerRunning)
+		{
+			activeScheduleIndex ^= 1;
+			schedulePending = false;
+			SoftPwmStartTimer();
+		}
+	}
+}
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void SoftPwmInit()
+{
+	ClearArray(channelDuty);
+	ClearArray(channelEnabled);
+	ClearArray(Schedules);
+	activeScheduleIndex = 0;
+	schedulePending = false;
+	timerRunning = false;
+	
+	//Figure out which ports the channels live on so each event only needs one store per port
+	numPwmPorts = 0;
+	u32 cIndex;
+	for (cIndex = 0; cIndex < SoftPwm_NumChannels; cIndex++)
+	{
+		const GpioPortRegs_t* portRegs = &GpioPorts[GpioPins[channelPins[cIndex]].port];
+		u32 pIndex;
+		for (pIndex = 0; pIndex < numPwmPorts; pIndex++)
+		{
+			if (pwmPorts[pIndex] == portRegs) { break; }
+		}
+		if (pIndex == numPwmPorts)
+		{
+			Assert(numPwmPorts < SOFT_PWM_MAX_PORTS);
+			pwmPorts[numPwmPorts] = portRegs;
+			numPwmPorts++;
+		}
+		channelPortIndex[cIndex] = (u8)pIndex;
+	}
+	
+	//+===============================+
+	//|         Timer5 Init           |
+	//+===============================+
+	T5CON = 0x0000;
+	T5CONbits.SIDL  = 0; // Continue in idle mode.
+	T5CONbits.TCKPS = SOFT_PWM_TIMER_TCKPS_VALUE; // Pre-scaler of 4. See SOFT_PWM_TIMER_PRESCALER
+	IPC6bits.T5IP = 3; IPC6bits.T5IS = 1; //Int priority 3.1
+	IFS0bits.T5IF = CLEARED;
+	IEC0bits.T5IE = DISABLED;
+}
+
+void SoftPwmSetDuty(SoftPwmChannel_t channel, u8 duty)
+{
+	Assert(channel < SoftPwm_NumChannels);
+	if (channelEnabled[channel] && channelDuty[channel] == duty) { return; }
+	channelDuty[channel] = duty;
+	channelEnabled[channel] = true;
+	SoftPwmRebuild();
+}
+
+//NOTE: The pin is left in whatever state it was in when the ISR picks up the new schedule
+void SoftPwmRelease(SoftPwmChannel_t channel)
+{
+	Assert(channel < SoftPwm_NumChannels);
+	if (!channelEnabled[channel]) { return; }
+	channelEnabled[channel] = false;
+	SoftPwmRebuild();
+}
+
+bool SoftPwmIsEnabled(SoftPwmChannel_t channel)
+{
+	Assert(channel < SoftPwm_NumChannels);
+	return channelEnabled[channel];
+}
+
+u8 SoftPwmGetDuty(SoftPwmChannel_t channel)
+{
+	Assert(channel < SoftPwm_NumChannels);
+	return channelDuty[channel];
+}
+
+bool SoftPwmFindByName(const char* name, u32 nameLength, SoftPwmChannel_t* channelOut)
+{
+	Gpio_t pin;
+	if (!GpioFindByName(name, nameLength, &pin)) { return false; }
+	u32 cIndex;
+	for (cIndex = 0; cIndex < SoftPwm_NumChannels; cIndex++)
+	{
+		if (channelPins[cIndex] == pin)
+		{
+			if (channelOut != nullptr) { *channelOut = (SoftPwmChannel_t)cIndex; }
+			return true;
+		}
+	}
+	return false;
+}
+
+void SoftPwmPrintChannels()
+{
+	const SoftPwmSchedule_t* schedule = &Schedules[activeScheduleIndex];
+	PrintLine_I("Software PWM at %uHz, %u/%u interrupts per period", SOFT_PWM_FREQUENCY, timerRunning ? schedule->numEvents : 0, SoftPwm_NumChannels + 1);
+	u32 cIndex;
+	for (cIndex = 0; cIndex < SoftPwm_NumChannels; cIndex++)
+	{
+		const char* pinName = GetGpioName(channelPins[cIndex]);
+		if (channelEnabled[cIndex]) { PrintLine_I("  %-8s %3u/%u (%u%%)", pinName, channelDuty[cIndex], SOFT_PWM_MAX_DUTY, ((u32)channelDuty[cIndex] * 100) / SOFT_PWM_MAX_DUTY); }
+		else { PrintLine_I("  %-8s off", pinName); }
+	}
+}
+
+// +--------------------------------------------------------------+
+// |                         Timer5 ISR                           |
+// +--------------------------------------------------------------+
+void __ISR(_TIMER_5_VECTOR, ipl3AUTO) SoftPwmTimerIsr()
+{
+	IFS0CLR = _IFS0_T5IF_MASK;
+	
+	if (eventIndex == 0 && schedulePending)
+	{
+		activeScheduleIndex ^= 1;
+		schedulePending = false;
+	}
+	
+	const SoftPwmSchedule_t* schedule = &Schedules[activeScheduleIndex];
+	const SoftPwmEvent_t* event = &schedule->events[eventIndex];
+	u32 pIndex;
+	for (pIndex = 0; pIndex < numPwmPorts; pIndex++)
+	{
+		if (event->setMasks[pIndex] != 0)   { *pwmPorts[pIndex]->latSetReg = event->setMasks[pIndex]; }
+		if (event->clearMasks[pIndex] != 0) { *pwmPorts[pIndex]->latClrReg = event->clearMasks[pIndex]; }
+	}
+	
+	//NOTE: TMR5 just rolled over so the new PR5 sets how long until the next event
+	eventIndex++;
+	u32 nextTimeCounts = SOFT_PWM_PERIOD_COUNTS;
+	if (eventIndex < schedule->numEvents) { nextTimeCounts = schedule->events[eventIndex].timeCounts; }
+	else { eventIndex = 0; }
+	PR5 = (nextTimeCounts - event->timeCounts) - 1;
+}
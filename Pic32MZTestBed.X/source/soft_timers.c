@@ -0,0 +1,195 @@
+/*
+File:   soft_timers.c
+Author: Taylor Robbins
+Date:   10\19\2026
+Description:
+	** Holds a software timer service for one-shot and periodic millisecond timers
+	** Timers are stored in a hashed timing wheel. Each timer lives in the slot (expireTimeMs % SOFT_TIMER_WHEEL_SIZE) and
+	** SoftTimersUpdate visits one slot per elapsed millisecond, so the cost of advancing time doesn't depend on how many
+	** timers exist. Timers further out than the wheel size simply get skipped until their expire time comes around.
+	
+	** TickTimerIsr doesn't know about any of this, it only advances TickCounterMs. All the timer processing and
+	** callbacks happen in the main loop inside SoftTimersUpdate
+	
+	** For tickless mode we tell the tick timer when the next timer expires (looking up to TICK_TIMER_MAX_TICKLESS_MS ahead)
+	** and ask for periodic ticks while any periodic timer shorter than SOFT_TIMER_SHORT_PERIOD is running
+*/
+
+#include "app.h"
+#include "soft_timers.h"
+
+#include "debug.h"
+#include "tick_timer.h"
+
+// +--------------------------------------------------------------+
+// |                     Private Definitions                      |
+// +--------------------------------------------------------------+
+#define SOFT_TIMER_WHEEL_MASK (SOFT_TIMER_WHEEL_SIZE-1)
+
+#if ((SOFT_TIMER_WHEEL_SIZE & SOFT_TIMER_WHEEL_MASK) != 0)
+#error SOFT_TIMER_WHEEL_SIZE must be a power of 2
+#endif
+#if (SOFT_TIMER_WHEEL_SIZE < TICK_TIMER_MAX_TICKLESS_MS)
+#error SOFT_TIMER_WHEEL_SIZE must cover at least TICK_TIMER_MAX_TICKLESS_MS
+#endif
+
+// +--------------------------------------------------------------+
+// |                       Private Globals                        |
+// +--------------------------------------------------------------+
+static SoftTimer_t* wheel[SOFT_TIMER_WHEEL_SIZE];
+static u32 wheelTimeMs = 0; //The next millisecond that SoftTimersUpdate needs to process
+static bool updating = false; //true while SoftTimersUpdate is running callbacks for the wheelTimeMs slot
+static u32 numActiveTimers = 0;
+static u32 numShortTimers = 0;
+static bool requestedPeriodic = false;
+static bool deadlineDirty = true;
+static u32 publishedDeadlineMs = 0;
+
+// +--------------------------------------------------------------+
+// |                      Private Functions                       |
+// +--------------------------------------------------------------+
+static void SoftTimerInsert(SoftTimer_t* timer)
+{
+	SoftTimer_t** slot = &wheel[timer->expireTimeMs & SOFT_TIMER_WHEEL_MASK];
+	timer->prev = nullptr;
+	timer->next = *slot;
+	if (*slot != nullptr) { (*slot)->prev = timer; }
+	*slot = timer;
+	timer->running = true;
+	numActiveTimers++;
+	if (timer->periodMs > 0 && timer->periodMs < SOFT_TIMER_SHORT_PERIOD) { numShortTimers++; }
+	deadlineDirty = true;
+}
+
+static void SoftTimerRemove(SoftTimer_t* timer)
+{
+	if (timer->prev != nullptr) { timer->prev->next = timer->next; }
+	else { wheel[timer->expireTimeMs & SOFT_TIMER_WHEEL_MASK] = timer->next; }
+	if (timer->next != nullptr) { timer->next->prev = timer->prev; }
+	timer->next = nullptr;
+	timer->prev = nullptr;
+	timer->running = false;
+	numActiveTimers--;
+	if (timer->periodMs > 0 && timer->periodMs < SOFT_TIMER_SHORT_PERIOD) { numShortTimers--; }
+	deadlineDirty = true;
+}
+
+static void SoftTimersPublishDeadline()
+{
+	bool wantPeriodic = (numShortTimers > 0);
+	if (wantPeriodic != requestedPeriodic)
+	{
+		TickTimerRequestPeriodic(TickPeriodicSource_SoftTimers, wantPeriodic);
+		requestedPeriodic = wantPeriodic;
+	}
+	
+	if (!deadlineDirty || !TickTimerIsTickless()) { return; }
+	deadlineDirty = false;
+	
+	u32 deadlineMs = wheelTimeMs + TICK_TIMER_MAX_TICKLESS_MS;
+	u32 msOffset;
+	for (msOffset = 0; msOffset < TICK_TIMER_MAX_TICKLESS_MS; msOffset++)
+	{
+		u32 slotTimeMs = wheelTimeMs + msOffset;
+		SoftTimer_t* timer = wheel[slotTimeMs & SOFT_TIMER_WHEEL_MASK];
+		while (timer != nullptr && timer->expireTimeMs != slotTimeMs) { timer = timer->next; }
+		if (timer != nullptr) { deadlineMs = slotTimeMs; break; }
+	}
+	
+	if (deadlineMs != publishedDeadlineMs)
+	{
+		TickTimerSetNextDeadline(deadlineMs);
+		publishedDeadlineMs = deadlineMs;
+	}
+}
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void SoftTimersInit()
+{
+	ClearArray(wheel);
+	wheelTimeMs = TickTimerGetMs();
+	numActiveTimers = 0;
+	numShortTimers = 0;
+	requestedPeriodic = false;
+	deadlineDirty = true;
+}
+
+void SoftTimerStart(SoftTimer_t* timer, u32 delayMs, u32 periodMs, SoftTimerCallback_f callback, void* userPntr)
+{
+	Assert(timer != nullptr);
+	if (timer->running) { SoftTimerRemove(timer); }
+	
+	timer->periodMs = periodMs;
+	timer->callback = callback;
+	timer->userPntr = userPntr;
+	timer->expireTimeMs = TickTimerGetMs() + delayMs;
+	//Anything due before the next slot we process would be missed for a full loop of the counter.
+	//From inside a callback the current slot is still being processed, so the earliest we can go is the slot after it
+	//(otherwise a timer restarted with no delay would fire again right away, over and over until the clock moves)
+	u32 earliestMs = updating ? wheelTimeMs + 1 : wheelTimeMs;
+	if (TimeIsBefore(timer->expireTimeMs, earliestMs)) { timer->expireTimeMs = earliestMs; }
+	SoftTimerInsert(timer);
+	SoftTimersPublishDeadline();
+}
+
+void SoftTimerStop(SoftTimer_t* timer)
+{
+	Assert(timer != nullptr);
+	if (timer->running) { SoftTimerRemove(timer); }
+	SoftTimersPublishDeadline();
+}
+
+bool SoftTimerIsRunning(const SoftTimer_t* timer)
+{
+	return timer->running;
+}
+
+u32 SoftTimerRemainingMs(const SoftTimer_t* timer)
+{
+	if (!timer->running) { return 0; }
+	i32 remaining = (i32)(timer->expireTimeMs - TickTimerGetMs());
+	return (remaining > 0) ? (u32)remaining : 0;
+}
+
+u32 SoftTimersNumActive()
+{
+	return numActiveTimers;
+}
+
+void SoftTimersUpdate()
+{
+	u32 currentTimeMs = TickTimerGetMs();
+	if (TimeHasReached(currentTimeMs, wheelTimeMs)) { deadlineDirty = true; }
+	updating = true;
+	while (TimeHasReached(currentTimeMs, wheelTimeMs))
+	{
+		SoftTimer_t** slot = &wheel[wheelTimeMs & SOFT_TIMER_WHEEL_MASK];
+		SoftTimer_t* timer = *slot;
+		while (timer != nullptr)
+		{
+			if (timer->expireTimeMs == wheelTimeMs)
+			{
+				SoftTimerRemove(timer);
+				if (timer->periodMs > 0)
+				{
+					timer->expireTimeMs += timer->periodMs;
+					SoftTimerInsert(timer);
+				}
+				//NOTE: The callback is allowed to start or stop any timer, including this one,
+				//      so we start over from the top of the slot afterwards rather than trusting timer->next
+				if (timer->callback != nullptr) { timer->callback(timer); }
+				timer = *slot;
+			}
+			else
+			{
+				timer = timer->next;
+			}
+		}
+		wheelTimeMs++;
+	}
+	updating = false;
+	
+	SoftTimersPublishDeadline();
+}
@@ -4,46 +4,123 @@ Author: Taylor Robbins
 Date:   08\29\2019
 Description: 
 	** Uses Timer9 as a tick timer to keep track of time with a 1ms accuracy
+	
+	** In tickless mode the timer isn't reloaded every millisecond. Instead PR9 is programmed so the next interrupt lands on the
+	** next deadline the soft timer service told us about (TickTimerSetNextDeadline), up to TICK_TIMER_MAX_TICKLESS_MS away.
+	** The ISR adds however many milliseconds the period was to TickCounterMs and TickTimerGetMs adds the partial period from TMR9.
+	** If anything asks for periodic ticks (TickTimerRequestPeriodic), like a soft timer with a short period, we drop back to 1ms interrupts
+	
+	** TimeNowCycles extends the 32-bit CP0 Count register (SYSCLK/2, wraps every ~43 seconds) to 64 bits. The tick ISR
+	** records the last Count value it saw and bumps the upper word whenever Count has wrapped since then. Readers take a
+	** snapshot of those two values plus the sequence number and retry if the ISR ran in the middle, so they never disable interrupts.
+	** This only works as long as the tick ISR runs at least once per Count wrap, which it always does (TICK_TIMER_MAX_TICKLESS_MS)
 */
 
 #include "app.h"
 #include "tick_timer.h"
 
+#include "micro.h"
+#include "debug.h"
+#include "isr_stats.h"
+#include "scheduler.h"
+
 // +--------------------------------------------------------------+
 // |                     Private Definitions                      |
 // +--------------------------------------------------------------+
-#define TICK_TIMER_ISR_PERIOD   1
-#define TICK_TIMER_PERIOD_TWEAK 6
-#define TICK_TIMER_PR_VALUE     3132//((TICK_TIMER_ISR_PERIOD * (MICRO_PERF_BUS_FREQ / 32L) / 1000L) - TICK_TIMER_PERIOD_TWEAK - 1)
+#define TICK_TIMER_ISR_PERIOD    1 //ms
+#define TICK_TIMER_PRESCALER     32
+#define TICK_TIMER_TCKPS_VALUE   0b101 //1:32, must match TICK_TIMER_PRESCALER
+#define TICK_TIMER_COUNTS_PER_MS (MICRO_PERF_BUS3_FREQ / TICK_TIMER_PRESCALER / 1000)
+#define TICK_TIMER_PR_VALUE      ((TICK_TIMER_ISR_PERIOD * TICK_TIMER_COUNTS_PER_MS) - 1) //The timer period is PR9+1 counts
+#define TICK_TIMER_PR_GUARD_COUNTS 8 //~2.5us, more than it takes to go from reading TMR9 to writing PR9 in TickTimerSetNextDeadline
+#define TICK_TIMER_CYCLES_PER_COUNT (TICK_TIMER_PRESCALER * (MICRO_SYS_CLK_FREQ / 2) / MICRO_PERF_BUS3_FREQ) //CP0 Count cycles per TMR9 count
+
+#if ((MICRO_PERF_BUS3_FREQ % (TICK_TIMER_PRESCALER * 1000)) != 0)
+#error PBCLK3 is not a whole number of timer counts per millisecond with this prescaler
+#endif
+#if ((TICK_TIMER_MAX_TICKLESS_MS * TICK_TIMER_COUNTS_PER_MS) > 0x10000)
+#error TICK_TIMER_MAX_TICKLESS_MS is too long for the 16-bit PR9 register
+#endif
 
 // +--------------------------------------------------------------+
 // |                        Public Globals                        |
 // +--------------------------------------------------------------+
 volatile u32 TickCounterMs  = 0; //Loops in 49.7 days
 volatile u32 TickCounterSec = 0; //Loops in 136.19 years
+volatile u32 TickTimerIsrCount = 0;
+volatile u32 TickTimerIsrsLastSecond = 0;
 
 // +==============================+
-// |     Ms Countdown Timers      |
+// |         Timer Groups         |
 // +==============================+
-volatile u32 DebugOutputBackoff = 0;
-volatile u32 ButtonDebounceTimer1 = 0;
-volatile u32 ButtonDebounceTimer2 = 0;
-volatile u32 ButtonDebounceTimer3 = 0;
+//NOTE: The timers themselves are declared in the lists in tick_timer.h
+#if (MS_COUNTDOWN_TIMER_COUNT > 0)
+volatile u32 MsCountdownTimers[MsCountdownTimer_NumTimers];
+#endif
+#if (MS_COUNTUP_TIMER_COUNT > 0)
+volatile u32 MsCountupTimers[MsCountupTimer_NumTimers];
+#endif
+#if (SEC_COUNTDOWN_TIMER_COUNT > 0)
+volatile u32 SecCountdownTimers[SecCountdownTimer_NumTimers];
+#endif
+#if (SEC_COUNTUP_TIMER_COUNT > 0)
+volatile u32 SecCountupTimers[SecCountupTimer_NumTimers];
+#endif
 
-// +==============================+
-// |      Ms Countup Timers       |
-// +==============================+
-//TODO: Add Ms Countup timers here
+// +--------------------------------------------------------------+
+// |                       Private Globals                        |
+// +--------------------------------------------------------------+
+static volatile bool ticklessEnabled = TICK_TIMER_TICKLESS_ENABLED;
+static volatile u8   periodicRequests = 0x00;
+static volatile u32  tickPeriodMs = 1; //Length of the period that Timer9 is currently counting
+static volatile u32  nextDeadlineMs = 0;
 
-// +==============================+
-// |     Sec Countdown Timers     |
-// +==============================+
-//TODO: Add Sec Countdown timers here
+static volatile u32 clockSequence = 0; //Incremented every time the tick ISR updates the two values below
+static volatile u32 clockCountHigh = 0;
+static volatile u32 clockLastCount = 0;
 
-// +==============================+
-// |      Sec Countup Timers      |
-// +==============================+
-//TODO: Add Sec Countup timers here
+// +--------------------------------------------------------------+
+// |                      Private Functions                       |
+// +--------------------------------------------------------------+
+//NOTE: Must be called with the Timer9 interrupt disabled (or from inside the ISR)
+static void TickTimerProgramPeriod(u32 periodMs)
+{
+	if (!ticklessEnabled || periodicRequests != 0x00 || periodMs <= 1)
+	{
+		tickPeriodMs = TICK_TIMER_ISR_PERIOD;
+		PR9 = TICK_TIMER_PR_VALUE;
+	}
+	else
+	{
+		if (periodMs > TICK_TIMER_MAX_TICKLESS_MS) { periodMs = TICK_TIMER_MAX_TICKLESS_MS; }
+		tickPeriodMs = periodMs;
+		PR9 = (periodMs * TICK_TIMER_COUNTS_PER_MS) - 1;
+	}
+}
+
+#if ((MS_COUNTDOWN_TIMER_COUNT + SEC_COUNTDOWN_TIMER_COUNT) > 0)
+static void TickTimerUpdateCountdowns(volatile u32* timers, u32 numTimers, u32 amount)
+{
+	u32 tIndex;
+	for (tIndex = 0; tIndex < numTimers; tIndex++)
+	{
+		u32 value = timers[tIndex];
+		timers[tIndex] = (value > amount) ? (value - amount) : 0;
+	}
+}
+#endif
+
+#if ((MS_COUNTUP_TIMER_COUNT + SEC_COUNTUP_TIMER_COUNT) > 0)
+static void TickTimerUpdateCountups(volatile u32* timers, u32 numTimers, u32 amount)
+{
+	u32 tIndex;
+	for (tIndex = 0; tIndex < numTimers; tIndex++)
+	{
+		u32 value = timers[tIndex];
+		timers[tIndex] = (value < 0xFFFFFFFF - amount) ? (value + amount) : 0xFFFFFFFF;
+	}
+}
+#endif
 
 // +--------------------------------------------------------------+
 // |                       Public Functions                       |
@@ -54,8 +131,9 @@ void TickTimerInit()
 	//|         Timer9 Init           |
 	//+===============================+
 	T9CONbits.SIDL  = 0; // Continue in idle mode.
-	T9CONbits.TCKPS = 0b101; // Pre-scaler of 32. If this is changed, change the PR9 calculation.
-	PR9 = TICK_TIMER_PR_VALUE; //Write the period register
+	T9CONbits.TCKPS = TICK_TIMER_TCKPS_VALUE; // Pre-scaler of 32. See TICK_TIMER_PRESCALER
+	TickTimerProgramPeriod(1); //Write the period register
+	clockLastCount = _CP0_GET_COUNT();
 	IPC10bits.T9IP  = 2; IPC10bits.T9IS = 0; //Int priority 2.0
 	
 	IFS1bits.T9IF = CLEARED; //Clear ISR flag
@@ -63,60 +141,197 @@ void TickTimerInit()
 	T9CONbits.ON  = ENABLED; //Enable timer
 }
 
-u32 TimeSinceMs(u32 counterValueMs)
+u32 TickTimerGetMs()
 {
-	if (TickCounterMs >= counterValueMs)
+	if (!ticklessEnabled) { return TickCounterMs; }
+	
+	u32 result;
+	u32 baseMs;
+	do
 	{
-		return (TickCounterMs - counterValueMs);
-	}
-	else
+		baseMs = TickCounterMs;
+		u32 periodMs = tickPeriodMs;
+		u32 timerValue = TMR9;
+		if (IFS1bits.T9IF)
+		{
+			//The period has ended but the ISR hasn't run yet (interrupts are probably disabled)
+			timerValue = TMR9;
+			result = baseMs + periodMs + (timerValue / TICK_TIMER_COUNTS_PER_MS);
+		}
+		else
+		{
+			result = baseMs + (timerValue / TICK_TIMER_COUNTS_PER_MS);
+		}
+	} while (baseMs != TickCounterMs);
+	
+	return result;
+}
+
+void TickTimerSetTickless(bool enabled)
+{
+	IEC1bits.T9IE = DISABLED;
+	ticklessEnabled = enabled;
+	IEC1bits.T9IE = ENABLED;
+	//NOTE: The new mode takes effect at the end of the current period
+}
+
+bool TickTimerIsTickless()
+{
+	return ticklessEnabled;
+}
+
+void TickTimerRequestPeriodic(TickPeriodicSource_t source, bool periodic)
+{
+	IEC1bits.T9IE = DISABLED;
+	if (periodic) { FlagSet(periodicRequests, source); }
+	else { FlagUnset(periodicRequests, source); }
+	IEC1bits.T9IE = ENABLED;
+}
+
+//Tells the tick timer when the next thing that cares about time is due. In tickless mode
+//this will shorten the current period if the new deadline comes before the end of it
+//NOTE: Only call this from the main loop. It turns all interrupts off and back on
+void TickTimerSetNextDeadline(u32 deadlineMs)
+{
+	//Every interrupt is off, not just Timer9, so nothing can delay us between reading TMR9 and writing PR9.
+	//If TMR9 got past the new PR9 in that window it would count all the way to 0xFFFF and we'd lose ~20ms
+	MicroDisableInterrupts();
+	nextDeadlineMs = deadlineMs;
+	if (ticklessEnabled && periodicRequests == 0x00 && tickPeriodMs > 1 && !IFS1bits.T9IF)
 	{
-		return (UINT32_MAX - counterValueMs) + TickCounterMs;
+		i32 msUntilDeadline = (i32)(deadlineMs - TickCounterMs);
+		if (msUntilDeadline < (i32)tickPeriodMs)
+		{
+			//Round up to the next whole millisecond boundary that the timer won't have reached by the time PR9 is written
+			u32 msElapsed = ((TMR9 + TICK_TIMER_PR_GUARD_COUNTS) / TICK_TIMER_COUNTS_PER_MS) + 1;
+			u32 newPeriodMs = (msUntilDeadline > (i32)msElapsed) ? (u32)msUntilDeadline : msElapsed;
+			if (newPeriodMs < tickPeriodMs) { TickTimerProgramPeriod(newPeriodMs); }
+		}
 	}
+	MicroEnableInterrupts();
 }
-u32 TimeSinceSec(u32 counterValueSec)
+
+u64 TimeNowCycles()
 {
-	if (TickCounterSec >= counterValueSec)
+	u32 sequence;
+	u32 countHigh;
+	u32 lastCount;
+	u32 count;
+	do
 	{
-		return (TickCounterSec - counterValueSec);
-	}
-	else
+		sequence = clockSequence;
+		countHigh = clockCountHigh;
+		lastCount = clockLastCount;
+		count = _CP0_GET_COUNT();
+	} while (sequence != clockSequence);
+	
+	//Count may have wrapped since the ISR last looked at it
+	if (count < lastCount) { countHigh++; }
+	return (((u64)countHigh << 32) | count);
+}
+
+u64 TimeNowUs()
+{
+	return TimeNowCycles() / TIME_CYCLES_PER_US;
+}
+
+u64 TimeSinceUs(u64 timeUs)
+{
+	u64 currentUs = TimeNowUs();
+	return (currentUs >= timeUs) ? (currentUs - timeUs) : 0;
+}
+
+//Gives a consistent snapshot of TickCounterMs and the CP0 cycle count that the tick ISR saw when it last ran.
+//Since both are captured at the same instant, the difference between two snapshots tells us how long the ticks really were
+void TickTimerGetLastTick(u32* tickMsOut, u64* cyclesOut)
+{
+	Assert(tickMsOut != nullptr && cyclesOut != nullptr);
+	u32 sequence;
+	do
 	{
-		return (UINT32_MAX - counterValueSec) + TickCounterSec;
-	}
+		sequence = clockSequence;
+		*tickMsOut = TickCounterMs;
+		*cyclesOut = (((u64)clockCountHigh << 32) | clockLastCount);
+	} while (sequence != clockSequence);
+}
+
+//Positive means the tick timer is running slow (each millisecond is too long) compared to the core clock
+i32 TickTimerCalculateDriftPpm(u32 elapsedMs, u64 elapsedCycles)
+{
+	if (elapsedMs == 0) { return 0; }
+	i64 expectedCycles = (i64)elapsedMs * MICRO_ONE_MS_COUNT;
+	return (i32)((((i64)elapsedCycles - expectedCycles) * 1000000) / expectedCycles);
+}
+
+//NOTE: Unsigned subtraction gives the right answer across a wrap as long as less than 49.7 days have passed
+u32 TimeSinceMs(u32 counterValueMs)
+{
+	return TickTimerGetMs() - counterValueMs;
+}
+u32 TimeSinceSec(u32 counterValueSec)
+{
+	return TickCounterSec - counterValueSec;
 }
 
 // +--------------------------------------------------------------+
 // |                        Tick Timer ISR                        |
 // +--------------------------------------------------------------+
 static volatile u16 secCounter = 0;
+static u32 isrCountAtLastSecond = 0;
 void __ISR(_TIMER_9_VECTOR, ipl2AUTO) TickTimerIsr(void)
 {
+	//TMR9 has been counting up from 0 since the period ended so it tells us how late we are
+	IsrStatsRecord(IsrStatId_TickTimer, TMR9 * TICK_TIMER_CYCLES_PER_COUNT);
+	
 	// +==============================+
 	// |      Millisecond Timers      |
 	// +==============================+
-	TickCounterMs++;
-	Decrement(DebugOutputBackoff);
-	Decrement(ButtonDebounceTimer1);
-	Decrement(ButtonDebounceTimer2);
-	Decrement(ButtonDebounceTimer3);
+	u32 elapsedMs = tickPeriodMs;
+	TickCounterMs += elapsedMs;
+	
+	//Higher priority interrupts may read the clock too so this update has to be atomic
+	MicroDisableInterrupts();
+	u32 count = _CP0_GET_COUNT();
+	if (count < clockLastCount) { clockCountHigh++; }
+	clockLastCount = count;
+	clockSequence++;
+	MicroEnableInterrupts();
 	
-	//TODO: Add Ms Countup timers here
+	TickTimerIsrCount++;
+	//NOTE: We're inside the Timer9 ISR so nothing else can be changing periodicRequests right now
+	if (DebugUartRxIdleTick(elapsedMs)) { FlagSet(periodicRequests, TickPeriodicSource_DebugRx); }
+	else { FlagUnset(periodicRequests, TickPeriodicSource_DebugRx); }
+	SchedulerWake();
 	
-	secCounter++;
+	#if (MS_COUNTDOWN_TIMER_COUNT > 0)
+	TickTimerUpdateCountdowns(&MsCountdownTimers[0], MsCountdownTimer_NumTimers, elapsedMs);
+	#endif
+	#if (MS_COUNTUP_TIMER_COUNT > 0)
+	TickTimerUpdateCountups(&MsCountupTimers[0], MsCountupTimer_NumTimers, elapsedMs);
+	#endif
+	
+	secCounter += elapsedMs;
 	if (secCounter >= 1000)
 	{
 		secCounter -= 1000;
+		TickTimerIsrsLastSecond = TickTimerIsrCount - isrCountAtLastSecond;
+		isrCountAtLastSecond = TickTimerIsrCount;
 		
 		// +==============================+
 		// |        Second Timers         |
 		// +==============================+
 		TickCounterSec++;
-		
-		//TODO: Add Sec Countdown timers here
-		
-		//TODO: Add Sec Countup timers here
+		#if (SEC_COUNTDOWN_TIMER_COUNT > 0)
+		TickTimerUpdateCountdowns(&SecCountdownTimers[0], SecCountdownTimer_NumTimers, 1);
+		#endif
+		#if (SEC_COUNTUP_TIMER_COUNT > 0)
+		TickTimerUpdateCountups(&SecCountupTimers[0], SecCountupTimer_NumTimers, 1);
+		#endif
 	}
 	
+	//NOTE: TMR9 just rolled over to 0 so it's safe to change PR9 for the period that is starting now
+	i32 msUntilDeadline = (i32)(nextDeadlineMs - TickCounterMs);
+	TickTimerProgramPeriod((msUntilDeadline > 0) ? (u32)msUntilDeadline : 1);
+	
 	IFS1CLR = _IFS1_T9IF_MASK;
 }
@@ -0,0 +1,216 @@
+/*
+File:   waveform.c
+Author: Taylor Robbins
+Date:   10\19\2026
+Description:
+	** Plays a table of steps out to TestPin1-6 with microsecond timing so the test bed can stimulate a device under test
+	** the same way every time. Each step drives some of the pins (all in one LATKINV store, see GpioPortWrite) and then
+	** waits delayUs before the next step. After the last step we go back to the first until we've played numLoops.
+	
+	** Timer4 times the steps. Its period register is reloaded with the next step's delay from inside the ISR, and since
+	** the timer keeps counting while we are getting into the ISR the step lengths don't depend on our interrupt latency.
+	** Delays longer than one 16-bit period are split into several periods and only the last one changes the pins.
+	
+	** Steps are loaded from the debug port with "wave add" and can't be changed while the waveform is playing
+*/
+
+#include "app.h"
+#include "waveform.h"
+
+#include "micro.h"
+#include "debug.h"
+#include "gpio.h"
+#include "work_queue.h"
+
+// +--------------------------------------------------------------+
+// |                     Private Definitions                      |
+// +--------------------------------------------------------------+
+#define WAVEFORM_TIMER_PRESCALER     4
+#define WAVEFORM_TIMER_TCKPS_VALUE   0b010 //1:4
+#define WAVEFORM_TIMER_COUNTS_PER_US (MICRO_PERF_BUS3_FREQ / WAVEFORM_TIMER_PRESCALER / 1000000) //25 at 100MHz
+#define WAVEFORM_TIMER_MAX_COUNTS    0x10000
+#define WAVEFORM_START_COUNTS        (WAVEFORM_MIN_DELAY_US * WAVEFORM_TIMER_COUNTS_PER_US)
+
+#if ((MICRO_PERF_BUS3_FREQ / WAVEFORM_TIMER_PRESCALER) % 1000000) != 0
+#error PBCLK3 is not a whole number of waveform timer counts per microsecond with this prescaler
+#endif
+
+// +--------------------------------------------------------------+
+// |                       Private Globals                        |
+// +--------------------------------------------------------------+
+static WaveformStep_t Steps[WAVEFORM_MAX_STEPS];
+static u32 numSteps = 0;
+static const GpioPortRegs_t* waveformPort = nullptr;
+
+static volatile bool playing = false;
+static volatile u32 stepIndex = 0;
+static volatile u32 remainingCounts = 0;
+static volatile u32 loopsPlayed = 0;
+static u32 loopsToPlay = 0; //0 means loop forever
+
+// +--------------------------------------------------------------+
+// |                      Private Functions                       |
+// +--------------------------------------------------------------+
+static void WaveformReportDone(u32 numLoops)
+{
+	PrintLine_I("Waveform finished after %u loop%s", numLoops, (numLoops == 1) ? "" : "s");
+}
+
+//NOTE: Leaves enough counts in remainingCounts that the final period is never too short for the ISR to keep up with
+static void WaveformProgramNextPeriod()
+{
+	u32 numCounts = remainingCounts;
+	if (numCounts > WAVEFORM_TIMER_MAX_COUNTS) { numCounts = WAVEFORM_TIMER_MAX_COUNTS / 2; }
+	remainingCounts -= numCounts;
+	PR4 = numCounts - 1;
+}
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void WaveformInit()
+{
+	ClearArray(Steps);
+	numSteps = 0;
+	playing = false;
+	waveformPort = &GpioPorts[GpioPins[Gpio_TestPin1].port];
+	
+	u32 pIndex;
+	for (pIndex = 0; pIndex < WAVEFORM_NUM_PINS; pIndex++)
+	{
+		//ISR writes the whole step in one store so every pin has to be on the same port
+		Assert(GpioPins[Gpio_TestPin1 + pIndex].port == GpioPins[Gpio_TestPin1].port);
+	}
+	
+	//+===============================+
+	//|         Timer4 Init           |
+	//+===============================+
+	T4CON = 0x0000;
+	T4CONbits.SIDL  = 0; // Continue in idle mode.
+	T4CONbits.TCKPS = WAVEFORM_TIMER_TCKPS_VALUE; // Pre-scaler of 4. See WAVEFORM_TIMER_PRESCALER
+	IPC4bits.T4IP = 6; IPC4bits.T4IS = 0; //Int priority 6.0, above everything else so step timing doesn't wait on other ISRs
+	IFS0bits.T4IF = CLEARED;
+	IEC0bits.T4IE = DISABLED;
+}
+
+bool WaveformAddStep(u8 pinMask, u8 pinValue, u32 delayUs)
+{
+	if (playing) { WriteLine_E("Can't change the waveform while it's playing"); return false; }
+	if (numSteps >= WAVEFORM_MAX_STEPS) { PrintLine_E("Waveform is full (%u steps)", WAVEFORM_MAX_STEPS); return false; }
+	if (delayUs < WAVEFORM_MIN_DELAY_US || delayUs > 0xFFFFFFFF / WAVEFORM_TIMER_COUNTS_PER_US)
+	{
+		PrintLine_E("Step delay must be %u-%uus", WAVEFORM_MIN_DELAY_US, 0xFFFFFFFF / WAVEFORM_TIMER_COUNTS_PER_US);
+		return false;
+	}
+	
+	WaveformStep_t* step = &Steps[numSteps];
+	step->pinMask = pinMask & ((1 << WAVEFORM_NUM_PINS) - 1);
+	step->pinValue = pinValue & step->pinMask;
+	step->delayUs = delayUs;
+	step->portMask = 0;
+	step->portValue = 0;
+	step->delayCounts = delayUs * WAVEFORM_TIMER_COUNTS_PER_US;
+	
+	u32 pIndex;
+	for (pIndex = 0; pIndex < WAVEFORM_NUM_PINS; pIndex++)
+	{
+		u32 pinPortMask = GpioPins[Gpio_TestPin1 + pIndex].mask;
+		if (IsFlagSet(step->pinMask,  (1 << pIndex))) { step->portMask  |= pinPortMask; }
+		if (IsFlagSet(step->pinValue, (1 << pIndex))) { step->portValue |= pinPortMask; }
+	}
+	
+	numSteps++;
+	return true;
+}
+
+void WaveformClear()
+{
+	WaveformStop();
+	ClearArray(Steps);
+	numSteps = 0;
+}
+
+bool WaveformPlay(u32 numLoops)
+{
+	if (numSteps == 0) { WriteLine_E("No waveform steps loaded"); return false; }
+	WaveformStop();
+	
+	stepIndex = 0;
+	loopsPlayed = 0;
+	loopsToPlay = numLoops;
+	remainingCounts = 0;
+	playing = true;
+	
+	//The first interrupt comes after WAVEFORM_START_COUNTS and plays step 0
+	TMR4 = 0;
+	PR4 = WAVEFORM_START_COUNTS - 1;
+	IFS0CLR = _IFS0_T4IF_MASK;
+	IEC0SET = _IEC0_T4IE_MASK;
+	T4CONbits.ON = ENABLED;
+	return true;
+}
+
+//NOTE: The pins are left however the last step drove them
+void WaveformStop()
+{
+	IEC0CLR = _IEC0_T4IE_MASK;
+	T4CONbits.ON = DISABLED;
+	IFS0CLR = _IFS0_T4IF_MASK;
+	playing = false;
+}
+
+bool WaveformIsPlaying()
+{
+	return playing;
+}
+
+void WaveformPrintSteps()
+{
+	if (playing)
+	{
+		if (loopsToPlay == 0) { PrintLine_I("Playing loop %u (forever)", loopsPlayed + 1); }
+		else { PrintLine_I("Playing loop %u/%u", loopsPlayed + 1, loopsToPlay); }
+	}
+	if (numSteps == 0) { WriteLine_I("No waveform steps loaded"); return; }
+	
+	u32 totalUs = 0;
+	u32 sIndex;
+	for (sIndex = 0; sIndex < numSteps; sIndex++)
+	{
+		const WaveformStep_t* step = &Steps[sIndex];
+		PrintLine_I("[%u] mask 0x%02X value 0x%02X then %uus", sIndex, step->pinMask, step->pinValue, step->delayUs);
+		totalUs += step->delayUs;
+	}
+	PrintLine_I("%u step%s, %uus per loop", numSteps, (numSteps == 1) ? "" : "s", totalUs);
+}
+
+// +--------------------------------------------------------------+
+// |                         Timer4 ISR                           |
+// +--------------------------------------------------------------+
+void __ISR(_TIMER_4_VECTOR, ipl6AUTO) WaveformTimerIsr()
+{
+	IFS0CLR = _IFS0_T4IF_MASK;
+	
+	//Still part way through a long delay
+	if (remainingCounts > 0) { WaveformProgramNextPeriod(); return; }
+	
+	if (stepIndex >= numSteps)
+	{
+		stepIndex = 0;
+		loopsPlayed++;
+		if (loopsToPlay > 0 && loopsPlayed >= loopsToPlay)
+		{
+			T4CONCLR = _T4CON_ON_MASK;
+			IEC0CLR = _IEC0_T4IE_MASK;
+			playing = false;
+			WorkQueuePost(WaveformReportDone, loopsPlayed);
+			return;
+		}
+	}
+	
+	const WaveformStep_t* step = &Steps[stepIndex];
+	*waveformPort->latInvReg = ((*waveformPort->latReg ^ step->portValue) & step->portMask);
+	remainingCounts = step->delayCounts;
+	WaveformProgramNextPeriod();
+	stepIndex++;
+}
@@ -0,0 +1,131 @@
+/*
+File:   work_queue.c
+Author: Taylor Robbins
+Date:   10\19\2026
+Description:
+	** Holds a queue of small function + argument records that ISRs can post to so their follow up work gets done in
+	** the main loop instead of inside the interrupt. WorkQueueUpdate runs as a background task and calls each one in order.
+	
+	** Any ISR (at any priority) can post while the main loop is the only consumer. Posting is lock-free: each slot has a
+	** sequence number and producers claim a slot by compare-and-swapping the enqueue position, so an ISR that interrupts
+	** another ISR part way through a post just claims the next slot. When the queue is full the item is dropped and counted.
+*/
+
+#include "app.h"
+#include "work_queue.h"
+
+#include "debug.h"
+#include "scheduler.h"
+
+// +--------------------------------------------------------------+
+// |                     Private Definitions                      |
+// +--------------------------------------------------------------+
+#define WORK_QUEUE_MASK (WORK_QUEUE_SIZE-1)
+
+#if ((WORK_QUEUE_SIZE & WORK_QUEUE_MASK) != 0)
+#error WORK_QUEUE_SIZE must be a power of 2
+#endif
+
+// +--------------------------------------------------------------+
+// |                        Public Globals                        |
+// +--------------------------------------------------------------+
+volatile u32 WorkQueueNumPosted  = 0;
+volatile u32 WorkQueueNumDropped = 0;
+volatile u32 WorkQueueMaxDepth   = 0;
+u32 WorkQueueNumExecuted = 0;
+
+// +--------------------------------------------------------------+
+// |                       Private Globals                        |
+// +--------------------------------------------------------------+
+static WorkItem_t workItems[WORK_QUEUE_SIZE];
+static volatile u32 enqueuePos = 0;
+static volatile u32 dequeuePos = 0;
+
+// +--------------------------------------------------------------+
+// |                       Public Functions                       |
+// +--------------------------------------------------------------+
+void WorkQueueInit()
+{
+	u32 wIndex;
+	for (wIndex = 0; wIndex < WORK_QUEUE_SIZE; wIndex++)
+	{
+		workItems[wIndex].sequence = wIndex;
+		workItems[wIndex].function = nullptr;
+		workItems[wIndex].arg = 0;
+	}
+	enqueuePos = 0;
+	dequeuePos = 0;
+	WorkQueueResetStats();
+}
+
+//NOTE: Safe to call from any ISR or from the main loop
+bool WorkQueuePost(WorkFunc_f function, u32 arg)
+{
+	u32 position;
+	WorkItem_t* item;
+	while (true)
+	{
+		position = enqueuePos;
+		item = &workItems[position & WORK_QUEUE_MASK];
+		i32 difference = (i32)(item->sequence - position);
+		if (difference == 0)
+		{
+			//The slot is free, try to claim it before anyone else does
+			if (__sync_bool_compare_and_swap(&enqueuePos, position, position + 1)) { break; }
+		}
+		else if (difference < 0)
+		{
+			//The consumer hasn't freed this slot yet so the queue is full
+			__sync_fetch_and_add(&WorkQueueNumDropped, 1);
+			return false;
+		}
+		//Otherwise another producer claimed this slot between our reads, try again with the new position
+	}
+	
+	item->function = function;
+	item->arg = arg;
+	item->sequence = position + 1; //publishes the item to the consumer
+	__sync_fetch_and_add(&WorkQueueNumPosted, 1);
+	
+	u32 depth = (position + 1) - dequeuePos;
+	u32 maxDepth = WorkQueueMaxDepth;
+	while (depth > maxDepth && !__sync_bool_compare_and_swap(&WorkQueueMaxDepth, maxDepth, depth)) { maxDepth = WorkQueueMaxDepth; }
+	
+	SchedulerWake();
+	return true;
+}
+
+u32 WorkQueueDepth()
+{
+	return enqueuePos - dequeuePos;
+}
+
+void WorkQueueUpdate()
+{
+	//Only handle as many items as the queue can hold so ISRs that keep posting can't keep us here forever
+	u32 numItems;
+	for (numItems = 0; numItems < WORK_QUEUE_SIZE; numItems++)
+	{
+		u32 position = dequeuePos;
+		WorkItem_t* item = &workItems[position & WORK_QUEUE_MASK];
+		if (item->sequence != position + 1) { return; } //empty (or the next item hasn't been published yet)
+		
+		WorkFunc_f function = item->function;
+		u32 arg = item->arg;
+		item->sequence = position + WORK_QUEUE_SIZE; //hands the slot back to the producers
+		dequeuePos = position + 1;
+		
+		if (function != nullptr) { function(arg); }
+		WorkQueueNumExecuted++;
+	}
+	
+	if (WorkQueueDepth() > 0) { SchedulerStayAwake(); }
+}
+
+void WorkQueueResetStats()
+{
+	WorkQueueNumPosted = 0;
+	WorkQueueNumDropped = 0;
+	WorkQueueMaxDepth = 0;
+	WorkQueueNumExecuted = 0;
+}